@@ -0,0 +1,72 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_BENCHMARK_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_BENCHMARK_HPP
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mine {
+
+/**
+ * Samples of named series, one per frame, summarized into a JSON report
+ */
+class Benchmark {
+  public:
+    struct Summary {
+        double mean{0.0};
+        double p50{0.0};
+        double p95{0.0};
+        double p99{0.0};
+        double max{0.0};
+    };
+
+    /**
+     * @param name std::string key in the report, with its unit, e.g.
+     * "frameMs"
+     * @return std::size_t index passed to record
+     */
+    std::size_t addSeries(std::string name);
+
+    /**
+     * Preallocate every series so recording doesn't allocate mid-run
+     */
+    void reserve(std::size_t samples);
+
+    void record(std::size_t series, double value);
+
+    /**
+     * Describe the run in the report
+     */
+    void setInfo(const std::string &key, const std::string &value);
+    void setInfo(const std::string &key, double value);
+
+    /**
+     * Nearest-rank percentiles of the samples
+     *
+     * @param samples std::vector<double>
+     * @return Summary all zero without samples
+     */
+    static Summary summarize(std::vector<double> samples);
+
+    /**
+     * @param path const char*
+     * @return bool false if the file couldn't be written
+     */
+    bool writeJson(const char *path) const;
+
+  private:
+    struct Series {
+        std::string name;
+        std::vector<double> samples;
+    };
+
+    std::vector<Series> series;
+
+    // Values are already JSON encoded
+    std::vector<std::pair<std::string, std::string>> info;
+};
+
+} // namespace mine
+
+#endif
@@ -22,6 +22,14 @@ class Camera {
     void move(Camera::Direction direction, float dt = 1.0f);
     void handleMouseMovement(glm::vec2 cursorPos, float dt = 1.0f);
     void setPosition(glm::vec3 position);
+    glm::vec3 getPosition() const;
+
+    /**
+     * Turn the camera towards a point, it must not be the camera's position
+     * nor straight above or below it
+     */
+    void lookAt(glm::vec3 target);
+
     glm::mat4 calculateLookAtMatrix();
 
   private:
@@ -0,0 +1,60 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_FLYTHROUGH_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_FLYTHROUGH_HPP
+
+#include "Camera.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <vector>
+
+namespace mine {
+
+/**
+ * A camera path through keyframes, interpolated with a Catmull-Rom spline.
+ * The view only depends on the path parameter, so runs driven by the frame
+ * number render the same frames every time.
+ */
+class Flythrough {
+  public:
+    struct Keyframe {
+        glm::vec3 position;
+        glm::vec3 target;
+    };
+
+    /**
+     * @param keyframes std::vector<Keyframe> at least two
+     */
+    explicit Flythrough(std::vector<Keyframe> keyframes);
+
+    /**
+     * Load a recorded path, one keyframe per line as
+     * "px py pz tx ty tz", lines starting with '#' are comments
+     *
+     * @param path const char*
+     * @return Flythrough
+     */
+    static Flythrough fromFile(const char *path);
+
+    /**
+     * Interpolated keyframe
+     *
+     * @param t float from 0 at the first keyframe to 1 at the last
+     * @return Keyframe
+     */
+    Keyframe sample(float t) const;
+
+    /**
+     * Move and turn the camera to its place on the path
+     *
+     * @param camera Camera&
+     * @param t float see sample
+     */
+    void apply(Camera &camera, float t) const;
+
+  private:
+    std::vector<Keyframe> keyframes;
+};
+
+} // namespace mine
+
+#endif
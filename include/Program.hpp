@@ -13,7 +13,8 @@ namespace mine {
 class Program {
   public:
     Program(const char *title = "Hello, World!", int width = 640,
-            int height = 480);
+            int height = 480,
+            opengl::WindowMode mode = opengl::WindowMode::VISIBLE);
 
     Program(const Program &other) = delete;
     void operator=(const Program &other) = delete;
@@ -0,0 +1,149 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_JOBS_INCLUDE_JOBS_JOBSYSTEM_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_JOBS_INCLUDE_JOBS_JOBSYSTEM_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mine {
+
+namespace jobs {
+
+enum class Priority {
+    HIGH,
+    NORMAL,
+    LOW,
+};
+
+/**
+ * Tracks completion of one job or a group of jobs
+ */
+class JobHandle {
+  public:
+    JobHandle();
+
+    bool isDone() const;
+
+  private:
+    friend class JobSystem;
+
+    std::shared_ptr<std::atomic<int>> pending;
+};
+
+/**
+ * Work-stealing thread pool for engine background work
+ *
+ * Every worker owns a deque per priority. Workers push and pop their own jobs
+ * at the back, and when they run dry they steal from the front of the other
+ * workers' deques, highest priority first. Threads waiting on a JobHandle run
+ * queued jobs instead of blocking.
+ */
+class JobSystem {
+  public:
+    using Job = std::function<void()>;
+
+    /**
+     * @param workerCount unsigned number of worker threads, at least one
+     */
+    JobSystem(unsigned int workerCount = defaultWorkerCount());
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    /**
+     * Finishes every queued job, then joins the workers
+     */
+    ~JobSystem();
+
+    /**
+     * Queue a job
+     *
+     * @param job Job
+     * @param priority Priority
+     * @return JobHandle done once the job has run
+     */
+    JobHandle submit(Job job, Priority priority = Priority::NORMAL);
+
+    /**
+     * Queue a job as part of an existing group
+     *
+     * @param job Job
+     * @param group JobHandle& done once every job added to it has run
+     * @param priority Priority
+     */
+    void submit(Job job, JobHandle &group,
+                Priority priority = Priority::NORMAL);
+
+    /**
+     * Block until the job (or group) is done, running other jobs meanwhile
+     *
+     * @param handle const JobHandle&
+     */
+    void wait(const JobHandle &handle);
+
+    /**
+     * Run `callback(i)` for every i in [0, count) across the pool and wait
+     * for all of them
+     *
+     * @param count std::size_t
+     * @param callback const std::function<void(std::size_t)>&
+     * @param priority Priority
+     */
+    void parallelFor(std::size_t count,
+                     const std::function<void(std::size_t)> &callback,
+                     Priority priority = Priority::NORMAL);
+
+    unsigned int getWorkerCount() const;
+
+    /**
+     * One worker per hardware thread, minus the main thread
+     */
+    static unsigned int defaultWorkerCount();
+
+  private:
+    static constexpr int PRIORITY_COUNT = 3;
+
+    struct Task {
+        Job job;
+        std::shared_ptr<std::atomic<int>> pending;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> queues[PRIORITY_COUNT];
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    std::atomic<bool> running{true};
+    std::atomic<int> queued{0};
+    std::atomic<unsigned int> nextWorker{0};
+
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+
+    void push(Task task, Priority priority);
+
+    /**
+     * Run a single queued job, if there is one
+     *
+     * @param self int index of the calling worker, -1 for other threads
+     * @return bool whether a job ran
+     */
+    bool runOne(int self);
+
+    void workerLoop(int self);
+};
+
+} // namespace jobs
+
+} // namespace mine
+
+#endif
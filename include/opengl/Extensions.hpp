@@ -0,0 +1,81 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_OPENGL_INCLUDE_OPENGL_EXTENSIONS_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_OPENGL_INCLUDE_OPENGL_EXTENSIONS_HPP
+
+#include "opengl/gl_includes.hpp"
+
+namespace mine {
+
+namespace opengl {
+
+// Tokens above the GL 3.3 core profile GLAD was generated for
+constexpr GLenum DRAW_INDIRECT_BUFFER = 0x8F3F;
+constexpr GLenum PROGRAM_BINARY_RETRIEVABLE_HINT = 0x8257;
+constexpr GLenum PROGRAM_BINARY_LENGTH = 0x8741;
+constexpr GLenum NUM_PROGRAM_BINARY_FORMATS = 0x87FE;
+
+using MultiDrawElementsIndirectProc = void(APIENTRYP)(GLenum mode, GLenum type,
+                                                      const void *indirect,
+                                                      GLsizei drawCount,
+                                                      GLsizei stride);
+
+using GetProgramBinaryProc = void(APIENTRYP)(GLuint program, GLsizei bufSize,
+                                             GLsizei *length,
+                                             GLenum *binaryFormat,
+                                             void *binary);
+
+using ProgramBinaryProc = void(APIENTRYP)(GLuint program, GLenum binaryFormat,
+                                          const void *binary, GLsizei length);
+
+using ProgramParameteriProc = void(APIENTRYP)(GLuint program, GLenum pname,
+                                              GLint value);
+
+using MaxShaderCompilerThreadsProc = void(APIENTRYP)(GLuint count);
+
+/**
+ * Optional GL functionality, detected once the context exists
+ *
+ * GLAD only loads the 3.3 core profile, newer entry points the renderer can
+ * take advantage of are resolved here and left null when unsupported.
+ */
+struct Extensions {
+    int majorVersion{3};
+    int minorVersion{3};
+
+    // GL 4.3 or ARB_multi_draw_indirect
+    MultiDrawElementsIndirectProc multiDrawElementsIndirect{nullptr};
+
+    // GL 4.1 or ARB_get_program_binary, left null when the driver offers no
+    // binary format
+    GetProgramBinaryProc getProgramBinary{nullptr};
+    ProgramBinaryProc programBinary{nullptr};
+    ProgramParameteriProc programParameteri{nullptr};
+
+    // KHR_parallel_shader_compile or its ARB twin, compiles and links then
+    // run on driver threads until their status is queried
+    MaxShaderCompilerThreadsProc maxShaderCompilerThreads{nullptr};
+
+    bool hasVersion(int major, int minor) const;
+};
+
+/**
+ * Query the current context, must be called after GLAD is loaded
+ *
+ * @param load GLADloadproc resolves entry points by name
+ */
+void loadExtensions(GLADloadproc load);
+
+const Extensions &getExtensions();
+
+/**
+ * Whether the current context advertises an extension
+ *
+ * @param name const char*
+ * @return bool
+ */
+bool hasExtension(const char *name);
+
+} // namespace opengl
+
+} // namespace mine
+
+#endif
@@ -29,6 +29,16 @@ class GLBuffer {
 
     void bufferData(GLsizeiptr size, const void *data, GLenum usage);
 
+    void bufferSubData(GLintptr offset, GLsizeiptr size, const void *data);
+
+    /**
+     * Bind to an indexed binding point of the target, e.g. a uniform block
+     * binding for GL_UNIFORM_BUFFER
+     *
+     * @param index GLuint
+     */
+    void bindBase(GLuint index);
+
     unsigned int get();
 
   private:
@@ -0,0 +1,89 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_OPENGL_INCLUDE_OPENGL_GLSTATE_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_OPENGL_INCLUDE_OPENGL_GLSTATE_HPP
+
+#include "opengl/gl_includes.hpp"
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+
+namespace mine {
+
+namespace opengl {
+
+/**
+ * Shadow copy of the context's bindings, used to skip redundant bind calls
+ *
+ * Every bind in the engine goes through here. Code calling GL directly must
+ * call invalidate() afterwards. GL thread only, there is one instance for the
+ * single context the program creates.
+ */
+class GLState {
+  public:
+    struct Stats {
+        std::uint64_t issued{0};
+        std::uint64_t skipped{0};
+    };
+
+    static GLState &get();
+
+    GLState(const GLState &) = delete;
+    GLState &operator=(const GLState &) = delete;
+
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vertexArray);
+    void bindBuffer(GLenum target, GLuint buffer);
+    void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+    void activeTexture(GLuint unit);
+    void bindTexture(GLuint unit, GLenum target, GLuint texture);
+
+    /**
+     * Forget a deleted object, GL implicitly unbinds it
+     */
+    void forgetProgram(GLuint program);
+    void forgetVertexArray(GLuint vertexArray);
+    void forgetBuffer(GLuint buffer);
+    void forgetTexture(GLuint texture);
+
+    /**
+     * Treat every binding as unknown, the next bind of each is issued
+     */
+    void invalidate();
+
+    const Stats &getStats() const;
+    void resetStats();
+
+  private:
+    GLState();
+
+    static constexpr GLuint UNKNOWN = ~0u;
+    static constexpr int BUFFER_TARGETS = 8;
+    static constexpr int TEXTURE_UNITS = 16;
+    static constexpr int TEXTURE_TARGETS = 4;
+    static constexpr int UNIFORM_BINDINGS = 16;
+
+    GLuint program;
+    GLuint vertexArray;
+    GLuint activeUnit;
+
+    // GL_ELEMENT_ARRAY_BUFFER is not tracked here, it is vertex array state
+    std::array<GLuint, BUFFER_TARGETS> buffers;
+    std::array<GLuint, UNIFORM_BINDINGS> uniformBindings;
+    std::array<std::array<GLuint, TEXTURE_TARGETS>, TEXTURE_UNITS> textures;
+
+    // Element buffer recorded in each vertex array
+    std::unordered_map<GLuint, GLuint> elementBuffers;
+
+    Stats stats;
+
+    bool update(GLuint &cached, GLuint value);
+
+    static int bufferSlot(GLenum target);
+    static int textureSlot(GLenum target);
+};
+
+} // namespace opengl
+
+} // namespace mine
+
+#endif
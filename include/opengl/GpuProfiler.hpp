@@ -0,0 +1,111 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_OPENGL_INCLUDE_OPENGL_GPUPROFILER_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_OPENGL_INCLUDE_OPENGL_GPUPROFILER_HPP
+
+#include "opengl/gl_includes.hpp"
+#include "utils/Profiler.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mine {
+
+namespace opengl {
+
+/**
+ * GPU time of render passes, recorded on a "GPU" track of utils::Profiler
+ *
+ * A pass is bracketed by two GL_TIMESTAMP queries. A frame's results are
+ * read FRAMES_IN_FLIGHT frames later, once the GPU is done with them, so
+ * timing never stalls the CPU. Frames the GPU still hasn't finished by then
+ * are dropped. GPU timestamps are moved onto the profiler's clock with an
+ * offset measured at the start of each frame.
+ *
+ * Passes are only timed while the profiler is enabled, and every call does
+ * nothing on drivers without timer queries.
+ */
+class GpuProfiler {
+  public:
+    static constexpr std::size_t FRAMES_IN_FLIGHT = 3;
+
+    GpuProfiler();
+
+    GpuProfiler(const GpuProfiler &) = delete;
+    GpuProfiler &operator=(const GpuProfiler &) = delete;
+
+    ~GpuProfiler();
+
+    bool isSupported() const;
+
+    /**
+     * Record the oldest frame's passes and start a new frame, call once per
+     * frame before its first pass
+     */
+    void beginFrame();
+
+    /**
+     * Start timing the commands that follow, passes may nest
+     *
+     * @param name const char* see utils::Profiler::record
+     */
+    void beginPass(const char *name);
+
+    /**
+     * Stop timing the innermost pass
+     */
+    void endPass();
+
+  private:
+    struct Pass {
+        const char *name;
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    struct Frame {
+        bool recording{false};
+        std::int64_t clockOffset{0};
+
+        std::vector<Pass> passes;
+
+        // Pooled, the first `used` hold this frame's timestamps
+        std::vector<GLuint> queries;
+        std::size_t used{0};
+    };
+
+    bool supported{false};
+
+    std::array<Frame, FRAMES_IN_FLIGHT> frames;
+    std::size_t current{0};
+
+    // Passes begun but not ended, innermost last
+    std::vector<std::size_t> open;
+
+    // Added on the first recorded pass
+    utils::Profiler::Track *track{nullptr};
+
+    std::size_t timestamp(Frame &frame);
+    void collect(Frame &frame);
+};
+
+/**
+ * Times its own lifetime as a GpuProfiler pass
+ */
+class GpuZone {
+  public:
+    GpuZone(GpuProfiler &profiler, const char *name);
+    ~GpuZone();
+
+    GpuZone(const GpuZone &) = delete;
+    GpuZone &operator=(const GpuZone &) = delete;
+
+  private:
+    GpuProfiler &profiler;
+};
+
+} // namespace opengl
+
+} // namespace mine
+
+#endif
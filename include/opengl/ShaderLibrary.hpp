@@ -0,0 +1,74 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_OPENGL_INCLUDE_OPENGL_SHADERLIBRARY_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_OPENGL_INCLUDE_OPENGL_SHADERLIBRARY_HPP
+
+#include "opengl/ShaderPreprocessor.hpp"
+#include "opengl/ShaderProgram.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace mine {
+
+namespace opengl {
+
+/**
+ * Compiled permutations of shader programs, keyed by their files and
+ * defines, so switching features on and off only compiles each variant once
+ */
+class ShaderLibrary {
+  public:
+    using Setup = std::function<void(ShaderProgram &)>;
+
+    /**
+     * @param setup Setup run once on each program before it is handed out,
+     * e.g. to bind uniform blocks
+     */
+    explicit ShaderLibrary(Setup setup = {});
+
+    /**
+     * Start compiling a permutation without waiting for it, see
+     * Link::DEFERRED
+     *
+     * @param vertexShaderPath const char*
+     * @param fragmentShaderPath const char*
+     * @param defines const ShaderDefines&
+     */
+    void prepare(const char *vertexShaderPath, const char *fragmentShaderPath,
+                 const ShaderDefines &defines = {});
+
+    /**
+     * A permutation ready to use, compiled on the first request
+     *
+     * @param vertexShaderPath const char*
+     * @param fragmentShaderPath const char*
+     * @param defines const ShaderDefines&
+     * @return ShaderProgram&
+     */
+    ShaderProgram &get(const char *vertexShaderPath,
+                       const char *fragmentShaderPath,
+                       const ShaderDefines &defines = {});
+
+    std::size_t size() const;
+
+  private:
+    struct Entry {
+        std::unique_ptr<ShaderProgram> program;
+        bool ready{false};
+    };
+
+    Setup setup;
+
+    std::unordered_map<std::string, Entry> programs;
+
+    Entry &find(const char *vertexShaderPath, const char *fragmentShaderPath,
+                const ShaderDefines &defines);
+};
+
+} // namespace opengl
+
+} // namespace mine
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_OPENGL_INCLUDE_OPENGL_SHADERPREPROCESSOR_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_OPENGL_INCLUDE_OPENGL_SHADERPREPROCESSOR_HPP
+
+#include <string>
+#include <vector>
+
+namespace mine {
+
+namespace opengl {
+
+/**
+ * Macros a shader is compiled with, each entry is the text following
+ * `#define`, a name optionally followed by its value, e.g. "FOG" or
+ * "FOG_START 0.5"
+ */
+using ShaderDefines = std::vector<std::string>;
+
+/**
+ * Load a shader and expand its `#include "file"` directives, paths are
+ * relative to the including file and each file is pasted at most once.
+ *
+ * The defines are inserted after the `#version` line, `#line` directives
+ * keep the driver's error messages pointing at the original lines, with the
+ * source number being the file's position in include order.
+ *
+ * @param path const char*
+ * @param defines const ShaderDefines&
+ * @return std::string
+ */
+std::string preprocessShader(const char *path, const ShaderDefines &defines);
+
+/**
+ * Text identifying a set of defines regardless of their order
+ *
+ * @param defines const ShaderDefines&
+ * @return std::string
+ */
+std::string definesKey(const ShaderDefines &defines);
+
+} // namespace opengl
+
+} // namespace mine
+
+#endif
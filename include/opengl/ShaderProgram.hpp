@@ -2,6 +2,7 @@
 #define KASOUZA_MINECRAFT_INCLUDE_OPENGL_INCLUDE_OPENGL_SHADERPROGRAM_HPP
 
 #include "glm/detail/qualifier.hpp"
+#include "opengl/ShaderPreprocessor.hpp"
 #include "opengl/gl_includes.hpp"
 
 #include <glm/glm.hpp>
@@ -9,7 +10,10 @@
 
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace mine {
 
@@ -36,16 +40,83 @@ unsigned int createShader(GLenum type, const char *source);
 unsigned int createProgram(const char *vertexShader,
                            const char *fragmentShader);
 
+/**
+ * @brief FNV-1a hash of a uniform name
+ *
+ * @param name std::string_view
+ *
+ * @return std::uint32_t
+ */
+constexpr std::uint32_t hashUniformName(std::string_view name) {
+    std::uint32_t hash{2166136261u};
+    for (char c : name) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief A resolved uniform location
+ *
+ */
+struct Uniform {
+    GLint location{-1};
+};
+
+/**
+ * @brief When a program's compile and link status is checked
+ *
+ */
+enum class Link {
+    // Wait for the driver while constructing
+    IMMEDIATE,
+    // Check on first use, so the driver compiles in the background meanwhile
+    DEFERRED,
+};
+
 /**
  * @brief A RAII wrapper for OpenGL shader programs
  *
+ * Uniform locations are looked up once after linking, so setting a uniform
+ * by name is a hash and a binary search, with no allocation and no driver
+ * round trip. Hot paths can keep the Uniform handle and skip even that.
+ *
+ * When a binary cache directory is set and the driver supports program
+ * binaries, linked programs are saved there keyed by their sources and the
+ * driver, and later loaded back instead of compiled.
+ *
+ * Deferred programs only submit their compile and link, constructing several
+ * of them back to back lets the driver work on all of them at once while the
+ * caller does something else. Errors are still fatal, but are reported when
+ * the program is first used.
  */
 class ShaderProgram {
   public:
+    /**
+     * Build a program from shader files, see preprocessShader
+     *
+     * @param vertexShaderPath const char*
+     * @param fragmentShaderPath const char*
+     * @param defines const ShaderDefines& added to both shaders
+     * @param link Link
+     * @return ShaderProgram
+     */
     static ShaderProgram fromFiles(const char *vertexShaderPath,
-                                   const char *fragmentShaderPath);
+                                   const char *fragmentShaderPath,
+                                   const ShaderDefines &defines = {},
+                                   Link link = Link::IMMEDIATE);
+
+    ShaderProgram(const char *vertexShader, const char *fragmentShader,
+                  Link link = Link::IMMEDIATE);
 
-    ShaderProgram(const char *vertexShader, const char *fragmentShader);
+    /**
+     * Where program binaries are cached, an empty path disables the cache
+     *
+     * @param directory std::string created when the first binary is saved
+     */
+    static void setBinaryCacheDirectory(std::string directory);
 
     ShaderProgram(const ShaderProgram &) = delete;
     ShaderProgram &operator=(const ShaderProgram &) = delete;
@@ -60,39 +131,64 @@ class ShaderProgram {
 
     unsigned int get();
 
-    template <size_t N>
-    void uniform(std::string name, glm::vec<N, float> value) {
+    /**
+     * Whether the program was loaded from the binary cache
+     */
+    bool isFromBinaryCache() const;
+
+    /**
+     * Location of an active uniform, resolved from the cache filled at link
+     * time. Unknown names give a handle that uniform() ignores, like
+     * glGetUniformLocation returning -1.
+     *
+     * @param name std::string_view
+     * @return Uniform
+     */
+    Uniform getUniform(std::string_view name);
+
+    /**
+     * Assign a uniform block to a binding point, blocks the program doesn't
+     * use are ignored
+     *
+     * @param blockName const char*
+     * @param bindingPoint GLuint
+     */
+    void bindUniformBlock(const char *blockName, GLuint bindingPoint);
+
+    template <size_t N, typename T>
+    void uniform(std::string_view name, glm::vec<N, T> value) {
+        this->uniform<N>(this->getUniform(name), value);
+    }
+
+    template <size_t N, typename T>
+    void uniform(std::string_view name, glm::mat<N, N, T> value) {
+        this->uniform<N>(this->getUniform(name), value);
+    }
+
+    template <size_t N> void uniform(Uniform handle, glm::vec<N, float> value) {
         if constexpr (N == 1) {
-            glUniform1fv(glGetUniformLocation(this->program, name.c_str()), 1,
-                         glm::value_ptr(value));
+            glUniform1fv(handle.location, 1, glm::value_ptr(value));
         } else if (N == 2) {
-            glUniform2fv(glGetUniformLocation(this->program, name.c_str()), 1,
-                         glm::value_ptr(value));
+            glUniform2fv(handle.location, 1, glm::value_ptr(value));
         } else if (N == 3) {
-            glUniform3fv(glGetUniformLocation(this->program, name.c_str()), 1,
-                         glm::value_ptr(value));
+            glUniform3fv(handle.location, 1, glm::value_ptr(value));
         } else if (N == 4) {
-            glUniform4fv(glGetUniformLocation(this->program, name.c_str()), 1,
-                         glm::value_ptr(value));
+            glUniform4fv(handle.location, 1, glm::value_ptr(value));
         } else {
             static_assert(N == 1 || N == 2 || N == 3 || N == 4,
                           "Invalid vector size");
         }
     }
 
-    template <size_t N> void uniform(std::string name, glm::vec<N, int> value) {
+    template <size_t N> void uniform(Uniform handle, glm::vec<N, int> value) {
         if constexpr (N == 1) {
-            glUniform1iv(glGetUniformLocation(this->program, name.c_str()), 1,
-                         glm::value_ptr(value));
+            glUniform1iv(handle.location, 1, glm::value_ptr(value));
         } else if (N == 2) {
-            glUniform2iv(glGetUniformLocation(this->program, name.c_str()), 1,
-                         glm::value_ptr(value));
+            glUniform2iv(handle.location, 1, glm::value_ptr(value));
         } else if (N == 3) {
-            glUniform3iv(glGetUniformLocation(this->program, name.c_str()), 1,
-                         glm::value_ptr(value));
+            glUniform3iv(handle.location, 1, glm::value_ptr(value));
         } else if (N == 4) {
-            glUniform4iv(glGetUniformLocation(this->program, name.c_str()), 1,
-                         glm::value_ptr(value));
+            glUniform4iv(handle.location, 1, glm::value_ptr(value));
         } else {
             static_assert(N == 1 || N == 2 || N == 3 || N == 4,
                           "Invalid vector size");
@@ -100,47 +196,77 @@ class ShaderProgram {
     }
 
     template <size_t N>
-    void uniform(std::string name, glm::mat<N, N, float> value) {
+    void uniform(Uniform handle, glm::mat<N, N, float> value) {
         if constexpr (N == 2) {
-            glUniformMatrix2fv(
-                glGetUniformLocation(this->program, name.c_str()), 1, GL_FALSE,
-                glm::value_ptr(value));
+            glUniformMatrix2fv(handle.location, 1, GL_FALSE,
+                               glm::value_ptr(value));
         } else if (N == 3) {
-            glUniformMatrix3fv(
-                glGetUniformLocation(this->program, name.c_str()), 1, GL_FALSE,
-                glm::value_ptr(value));
+            glUniformMatrix3fv(handle.location, 1, GL_FALSE,
+                               glm::value_ptr(value));
         } else if (N == 4) {
-            glUniformMatrix4fv(
-                glGetUniformLocation(this->program, name.c_str()), 1, GL_FALSE,
-                glm::value_ptr(value));
+            glUniformMatrix4fv(handle.location, 1, GL_FALSE,
+                               glm::value_ptr(value));
         } else {
             static_assert(N == 2 || N == 3 || N == 4, "Invalid matrix size");
         }
     }
 
     template <size_t N>
-    void uniform(std::string name, glm::mat<N, N, int> value) {
+    void uniform(Uniform handle, glm::mat<N, N, int> value) {
         if constexpr (N == 2) {
-            glUniformMatrix2iv(
-                glGetUniformLocation(this->program, name.c_str()), 1, GL_FALSE,
-                glm::value_ptr(value));
+            glUniformMatrix2iv(handle.location, 1, GL_FALSE,
+                               glm::value_ptr(value));
         } else if (N == 3) {
-            glUniformMatrix3iv(
-                glGetUniformLocation(this->program, name.c_str()), 1, GL_FALSE,
-                glm::value_ptr(value));
+            glUniformMatrix3iv(handle.location, 1, GL_FALSE,
+                               glm::value_ptr(value));
         } else if (N == 4) {
-            glUniformMatrix4iv(
-                glGetUniformLocation(this->program, name.c_str()), 1, GL_FALSE,
-                glm::value_ptr(value));
+            glUniformMatrix4iv(handle.location, 1, GL_FALSE,
+                               glm::value_ptr(value));
         } else {
             static_assert(N == 2 || N == 3 || N == 4, "Invalid matrix size");
         }
     }
 
   private:
+    struct CachedUniform {
+        std::uint32_t hash;
+        GLint location;
+        std::string name;
+    };
+
     unsigned int program;
+    bool fromBinaryCache{false};
+    bool linked{false};
+
+    // Only set while a deferred compile hasn't been checked yet
+    unsigned int vertexShader{0};
+    unsigned int fragmentShader{0};
+
+    // Saved once the link is known to have succeeded
+    bool saveBinary{false};
+    std::uint64_t binaryKey{0};
+
+    // Sorted by hash
+    std::vector<CachedUniform> uniforms;
+
+    void cacheUniforms();
+
+    /**
+     * Load the program from the binary cache, or compile it and save it
+     */
+    void load(const char *vertexShader, const char *fragmentShader);
+
+    /**
+     * Check the compile and link status, then cache the uniforms. Does
+     * nothing once the program has been checked.
+     */
+    void finish();
+
+    void save();
 };
 
+} // namespace opengl
+
+} // namespace mine
+
 #endif
-}
-}
@@ -0,0 +1,54 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_OPENGL_INCLUDE_OPENGL_TEXTURE_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_OPENGL_INCLUDE_OPENGL_TEXTURE_HPP
+
+#include "opengl/GLBuffer.hpp"
+#include "opengl/gl_includes.hpp"
+
+namespace mine {
+
+namespace opengl {
+
+/**
+ * RAII wrapper for OpenGL texture objects
+ */
+class Texture {
+  public:
+    Texture(const Texture &other) = delete;
+    void operator=(const Texture &other) = delete;
+
+    Texture(GLenum target = GL_TEXTURE_2D);
+
+    Texture(Texture &&other) noexcept;
+    void operator=(Texture &&other) noexcept;
+
+    ~Texture();
+
+    /**
+     * Bind to a texture unit
+     *
+     * @param unit GLuint
+     */
+    void bind(GLuint unit = 0);
+
+    /**
+     * Attach a buffer's storage, only for GL_TEXTURE_BUFFER textures
+     *
+     * @param internalFormat GLenum
+     * @param buffer GLBuffer&
+     */
+    void texBuffer(GLenum internalFormat, GLBuffer &buffer);
+
+    GLenum getTarget() const;
+
+    unsigned int get();
+
+  private:
+    unsigned int id;
+    GLenum target;
+};
+
+} // namespace opengl
+
+} // namespace mine
+
+#endif
@@ -34,6 +34,13 @@ class VertexArray {
     void vertexAttribPointer(unsigned int index, int size, GLenum type,
                              bool normalized, int stride, void *pointer);
 
+    /**
+     * Like vertexAttribPointer, but the attribute stays an integer in the
+     * shader (`in uint`, `in ivec3`...) instead of being converted to float
+     */
+    void vertexAttribIPointer(unsigned int index, int size, GLenum type,
+                              int stride, void *pointer);
+
     GLBuffer &addBuffer(GLenum target = GL_ARRAY_BUFFER);
 
     GLBuffer &getBuffer(unsigned int index);
@@ -9,8 +9,31 @@ namespace mine {
 
 namespace opengl {
 
+/**
+ * @brief Where a Window's frames end up
+ *
+ */
+enum class WindowMode {
+    VISIBLE,
+    // Hidden window rendering into an offscreen framebuffer, for machines
+    // without a display
+    HEADLESS,
+};
+
+/**
+ * Ask GLFW for its null platform when there is no display to connect to,
+ * must be called before glfwInit. Contexts then come from EGL without a
+ * surface, which Mesa's software rasterizer supports. Needs GLFW 3.4, older
+ * versions keep their default platform.
+ */
+void preferHeadlessPlatform();
+
 /**
  * A wrapper around GLFWwindow
+ *
+ * Headless windows are never shown, their framebuffer object is bound as
+ * the default target in place of the window's own framebuffer, which a
+ * surfaceless context doesn't have.
  */
 class Window {
   public:
@@ -22,7 +45,7 @@ class Window {
     void operator=(Window &&other);
 
     Window(const char *title = "Hello World", int width = 640,
-           int height = 480);
+           int height = 480, WindowMode mode = WindowMode::VISIBLE);
 
     ~Window();
 
@@ -44,11 +67,23 @@ class Window {
     bool isKeyPressed(int key);
     glm::vec2 getCursorPos();
 
+    bool isHeadless() const;
+
     GLFWwindow *get();
 
   private:
     GLFWwindow *window;
 
+    // Only used by headless windows
+    GLuint framebuffer{0};
+    GLuint colorBuffer{0};
+    GLuint depthBuffer{0};
+    int framebufferWidth{0};
+    int framebufferHeight{0};
+
+    void createFramebuffer(int width, int height);
+    void deleteFramebuffer();
+
     void viewport(int width, int height);
 };
 
@@ -0,0 +1,69 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_RENDER_INCLUDE_RENDER_BLOCKTEXTURES_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_RENDER_INCLUDE_RENDER_BLOCKTEXTURES_HPP
+
+#include "jobs/JobSystem.hpp"
+#include "opengl/Texture.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mine {
+
+namespace render {
+
+/**
+ * Every block texture in one GL_TEXTURE_2D_ARRAY, a layer per entry of
+ * world::TEXTURE_FILES
+ *
+ * The PNGs are decoded with stb_image on the job system and their mipmaps
+ * computed on the CPU. The result is cached on disk keyed by a hash of the
+ * source files, later startups with unchanged sources upload the cache
+ * without decoding anything.
+ */
+class BlockTextures {
+  public:
+    // Width and height of every block texture
+    static constexpr int SIZE = 16;
+
+    // Mip levels down to 1x1
+    static constexpr int LEVELS = 5;
+
+    // Texture unit the array is bound to, see shaders/fragment.glsl
+    static constexpr GLuint UNIT = 0;
+
+    /**
+     * @param directory const char* where the PNGs live
+     * @param cachePath const char* cache file, created if missing or stale
+     * @param jobSystem jobs::JobSystem&
+     */
+    BlockTextures(const char *directory, const char *cachePath,
+                  jobs::JobSystem &jobSystem);
+
+    void bind();
+
+    /**
+     * Whether the texture came from the disk cache
+     */
+    bool isFromCache() const;
+
+  private:
+    opengl::Texture texture;
+    bool fromCache{false};
+
+    /**
+     * Decode the sources and build every mip level, level by level with all
+     * layers of a level next to each other like glTexImage3D wants them
+     */
+    static std::vector<unsigned char>
+    decode(const std::vector<std::vector<unsigned char>> &sources,
+           jobs::JobSystem &jobSystem);
+
+    void upload(const unsigned char *pixels);
+};
+
+} // namespace render
+
+} // namespace mine
+
+#endif
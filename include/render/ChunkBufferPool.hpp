@@ -0,0 +1,196 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_RENDER_INCLUDE_RENDER_CHUNKBUFFERPOOL_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_RENDER_INCLUDE_RENDER_CHUNKBUFFERPOOL_HPP
+
+#include "opengl/GLBuffer.hpp"
+#include "opengl/Texture.hpp"
+#include "opengl/VertexArray.hpp"
+#include "render/ChunkMesher.hpp"
+#include "utils/RangeAllocator.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mine {
+
+namespace render {
+
+/**
+ * Where a chunk mesh lives inside a ChunkBufferPool, in vertices and indices
+ */
+struct MeshAllocation {
+    std::size_t vertexOffset{0};
+    std::size_t vertexCount{0};
+    std::size_t indexOffset{0};
+    std::size_t indexCount{0};
+};
+
+/**
+ * How a batch of meshes is submitted
+ */
+enum class DrawPath {
+    // One glDrawElementsBaseVertex per mesh
+    PER_MESH,
+    // One glMultiDrawElementsBaseVertex for the whole batch
+    MULTI_DRAW,
+    // One glMultiDrawElementsIndirect, commands read from a buffer
+    MULTI_DRAW_INDIRECT,
+};
+
+/**
+ * Every chunk mesh, suballocated from one large vertex buffer and one large
+ * index buffer behind a single vertex array
+ *
+ * Indices stay local to their mesh and are drawn with a base vertex. Meshes
+ * are referred to by handle since compaction moves them around. When an
+ * allocation doesn't fit, the pool compacts live meshes into fresh buffers,
+ * growing them if fragmentation alone doesn't explain the failure.
+ *
+ * Vertices are allocated in pages of PAGE_SIZE, and a buffer texture holds
+ * the chunk origin of every page. The vertex shader finds its chunk's origin
+ * from gl_VertexID (which includes the base vertex), so a whole batch of
+ * chunks can be drawn in one call without per-chunk uniforms.
+ */
+class ChunkBufferPool {
+  public:
+    using Handle = std::uint32_t;
+    static constexpr Handle INVALID_HANDLE = ~Handle{0};
+
+    // Must match the shift in shaders/vertex.glsl
+    static constexpr std::size_t PAGE_SIZE = 64;
+
+    // Texture unit the page origins are bound to
+    static constexpr GLuint ORIGINS_UNIT = 1;
+
+    ChunkBufferPool(std::size_t vertexCapacity = 256 * 1024,
+                    std::size_t indexCapacity = 384 * 1024);
+
+    ChunkBufferPool(const ChunkBufferPool &) = delete;
+    ChunkBufferPool &operator=(const ChunkBufferPool &) = delete;
+
+    /**
+     * Upload a mesh into the pool
+     *
+     * @param data const MeshData& must not be empty
+     * @param origin glm::ivec3 world position of the mesh's local origin
+     * @return Handle
+     */
+    Handle allocate(const MeshData &data, glm::ivec3 origin);
+
+    /**
+     * Release a mesh, INVALID_HANDLE is ignored
+     */
+    void free(Handle handle);
+
+    /**
+     * Replace a mesh's contents, reusing its ranges when the new data fits
+     *
+     * @param handle Handle may be INVALID_HANDLE
+     * @param data const MeshData& may be empty, which frees the mesh
+     * @param origin glm::ivec3
+     * @return Handle the mesh's (possibly new) handle
+     */
+    Handle update(Handle handle, const MeshData &data, glm::ivec3 origin);
+
+    const MeshAllocation &get(Handle handle) const;
+
+    /**
+     * Move every live mesh to the start of fresh buffers of the given
+     * capacity, leaving a single free range at the end
+     */
+    void compact(std::size_t vertexCapacity, std::size_t indexCapacity);
+
+    /**
+     * Bind the vertex array and the page origins texture
+     */
+    void bind();
+
+    /**
+     * Draw one mesh, the pool must be bound
+     */
+    void draw(Handle handle);
+
+    /**
+     * Draw many meshes, the pool must be bound
+     *
+     * MULTI_DRAW_INDIRECT falls back to MULTI_DRAW when the context has no
+     * glMultiDrawElementsIndirect.
+     *
+     * @param handles const std::vector<Handle>&
+     * @param path DrawPath
+     */
+    void draw(const std::vector<Handle> &handles, DrawPath path);
+
+    /**
+     * Whether the indirect path is available in this context
+     */
+    static bool supportsIndirect();
+
+    opengl::VertexArray &getVertexArray();
+
+    std::size_t getVertexCapacity() const;
+    std::size_t getIndexCapacity() const;
+    std::size_t getUsedBytes() const;
+    float getFragmentation() const;
+
+  private:
+    struct Slot {
+        MeshAllocation allocation;
+        glm::ivec3 origin{0};
+
+        // Sizes reserved in the allocators, may exceed the current counts
+        // when an update reused a larger range
+        std::size_t pagesReserved{0};
+        std::size_t indexReserved{0};
+
+        bool live{false};
+    };
+
+    // Matches the DrawElementsIndirectCommand layout GL expects
+    struct IndirectCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint baseVertex;
+        GLuint baseInstance;
+    };
+
+    opengl::VertexArray vao;
+
+    // One origin per vertex page, read through a buffer texture
+    opengl::GLBuffer originsBuffer;
+    opengl::Texture originsTexture;
+    std::vector<glm::ivec4> pageOrigins;
+
+    utils::RangeAllocator pages;
+    utils::RangeAllocator indices;
+
+    std::vector<Slot> slots;
+    std::vector<Handle> freeHandles;
+
+    // Reused every frame by the batched draw paths
+    std::vector<GLsizei> counts;
+    std::vector<void *> indexOffsets;
+    std::vector<GLint> baseVertices;
+    std::vector<IndirectCommand> commands;
+    opengl::GLBuffer indirectBuffer;
+
+    static opengl::VertexArray createVertexArray(std::size_t vertexCapacity,
+                                                 std::size_t indexCapacity);
+
+    static std::size_t pagesFor(std::size_t vertexCount);
+
+    bool reserve(Slot &slot, const MeshData &data);
+
+    void write(Slot &slot, const MeshData &data);
+
+    void resizeOrigins(std::size_t pageCapacity);
+};
+
+} // namespace render
+
+} // namespace mine
+
+#endif
@@ -0,0 +1,176 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_RENDER_INCLUDE_RENDER_CHUNKMESHER_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_RENDER_INCLUDE_RENDER_CHUNKMESHER_HPP
+
+#include "world/World.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace mine {
+
+namespace render {
+
+/**
+ * Packed 32-bit vertex of chunk meshes, decoded in shaders/vertex.glsl
+ *
+ * | bits  | field                              |
+ * |-------|------------------------------------|
+ * | 0-4   | x, local to the chunk (0 to 16)    |
+ * | 5-9   | y                                  |
+ * | 10-14 | z                                  |
+ * | 15-17 | face normal, index into the faces  |
+ * | 18-19 | ambient occlusion, 3 is unoccluded |
+ * | 20-23 | light level                        |
+ * | 24-31 | texture layer                      |
+ */
+struct ChunkVertex {
+    std::uint32_t data;
+
+    static ChunkVertex pack(unsigned int x, unsigned int y, unsigned int z,
+                            unsigned int normal, unsigned int textureLayer,
+                            unsigned int ao = 3, unsigned int light = 15) {
+        assert(x <= 16 && y <= 16 && z <= 16);
+        assert(normal < 6 && ao < 4 && light < 16 && textureLayer < 256);
+
+        return {x | (y << 5) | (z << 10) | (normal << 15) | (ao << 18) |
+                (light << 20) | (textureLayer << 24)};
+    }
+
+    unsigned int getX() const { return this->data & 31; }
+    unsigned int getY() const { return (this->data >> 5) & 31; }
+    unsigned int getZ() const { return (this->data >> 10) & 31; }
+    unsigned int getNormal() const { return (this->data >> 15) & 7; }
+    unsigned int getAO() const { return (this->data >> 18) & 3; }
+    unsigned int getLight() const { return (this->data >> 20) & 15; }
+    unsigned int getTextureLayer() const { return this->data >> 24; }
+};
+
+static_assert(sizeof(ChunkVertex) == 4, "ChunkVertex must stay packed");
+
+/**
+ * CPU side mesh, ready to be uploaded to a ChunkBufferPool
+ */
+struct MeshData {
+    std::vector<ChunkVertex> vertices;
+    std::vector<unsigned int> indices;
+
+    void clear();
+    bool empty() const;
+};
+
+/**
+ * A copy of a chunk's blocks plus a one block border taken from its
+ * neighbours, so faces on the chunk boundary can be culled without touching
+ * the World while meshing
+ */
+class PaddedSection {
+  public:
+    static constexpr int SIZE = world::Chunk::SIZE + 2;
+    static constexpr int VOLUME = SIZE * SIZE * SIZE;
+
+    /**
+     * Copy a chunk and its border out of the world
+     *
+     * @param world const world::World&
+     * @param chunkPosition glm::ivec3 chunk coordinate
+     * @return PaddedSection
+     */
+    static PaddedSection gather(const world::World &world,
+                                glm::ivec3 chunkPosition);
+
+    /**
+     * Get a block, coordinates range from -1 to Chunk::SIZE inclusive
+     */
+    world::BlockId get(int x, int y, int z) const {
+        assert(x >= -1 && x <= world::Chunk::SIZE);
+        assert(y >= -1 && y <= world::Chunk::SIZE);
+        assert(z >= -1 && z <= world::Chunk::SIZE);
+
+        return this->blocks[index(x, y, z)];
+    }
+
+    void set(int x, int y, int z, world::BlockId block) {
+        this->blocks[index(x, y, z)] = block;
+    }
+
+    /**
+     * Whether the chunk itself (excluding the border) has no solid blocks
+     */
+    bool isEmpty() const { return this->empty; }
+
+  private:
+    std::array<world::BlockId, VOLUME> blocks{};
+    bool empty{true};
+
+    static int index(int x, int y, int z) {
+        return ((y + 1) * SIZE + (z + 1)) * SIZE + (x + 1);
+    }
+};
+
+/**
+ * Meshing algorithms, selectable at runtime to compare their output
+ */
+enum class MeshingMode {
+    CULLED,
+    GREEDY,
+    BINARY,
+};
+
+/**
+ * Turns chunk blocks into renderable geometry
+ */
+class ChunkMesher {
+  public:
+    ChunkMesher(MeshingMode mode = MeshingMode::BINARY);
+
+    /**
+     * Emit one quad per block face that touches a transparent block
+     *
+     * @param section const PaddedSection&
+     * @param out MeshData& cleared before meshing
+     */
+    void meshCulled(const PaddedSection &section, MeshData &out) const;
+
+    /**
+     * Like meshCulled, but merges coplanar adjacent faces of the same block
+     * into larger quads
+     *
+     * @param section const PaddedSection&
+     * @param out MeshData& cleared before meshing
+     */
+    void meshGreedy(const PaddedSection &section, MeshData &out) const;
+
+    /**
+     * Greedy meshing on occupancy bitmasks
+     *
+     * Every column of the padded section along each axis is stored as a
+     * bitmask of solid blocks, visible faces fall out of a shift and an AND
+     * per column, and faces are merged by scanning the bits of each slice row
+     * with count-trailing-zeros rather than testing blocks one by one.
+     *
+     * @param section const PaddedSection&
+     * @param out MeshData& cleared before meshing
+     */
+    void meshBinary(const PaddedSection &section, MeshData &out) const;
+
+    /**
+     * Mesh with the current mode
+     */
+    void mesh(const PaddedSection &section, MeshData &out) const;
+
+    MeshingMode getMode() const;
+    void setMode(MeshingMode mode);
+
+  private:
+    MeshingMode mode;
+};
+
+} // namespace render
+
+} // namespace mine
+
+#endif
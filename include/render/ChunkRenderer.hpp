@@ -0,0 +1,258 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_RENDER_INCLUDE_RENDER_CHUNKRENDERER_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_RENDER_INCLUDE_RENDER_CHUNKRENDERER_HPP
+
+#include "jobs/JobSystem.hpp"
+#include "opengl/ShaderProgram.hpp"
+#include "render/ChunkBufferPool.hpp"
+#include "render/ChunkMesher.hpp"
+#include "render/Frustum.hpp"
+#include "render/FrustumCuller.hpp"
+#include "render/OcclusionCuller.hpp"
+#include "render/OcclusionQueries.hpp"
+#include "render/SectionVisibility.hpp"
+#include "utils/MpscQueue.hpp"
+#include "world/World.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace mine {
+
+namespace render {
+
+/**
+ * How chunks hidden behind terrain are culled, on top of the frustum and
+ * visibility walk
+ */
+enum class OcclusionMode {
+    NONE,
+    // Rasterize opaque sections on the CPU, see OcclusionCuller
+    SOFTWARE,
+    // GPU queries on chunk boxes answered one frame late, see
+    // OcclusionQueries
+    HARDWARE,
+};
+
+/**
+ * Keeps a mesh for every loaded chunk and draws them
+ *
+ * Dirty chunks are meshed on the job system. Finished meshes come back to
+ * the GL thread through a lock-free queue and are uploaded under a per-frame
+ * budget, so a burst of dirty chunks is spread over several frames instead of
+ * stalling one.
+ */
+class ChunkRenderer {
+  public:
+    ChunkRenderer(jobs::JobSystem &jobSystem);
+
+    ChunkRenderer(const ChunkRenderer &) = delete;
+    ChunkRenderer &operator=(const ChunkRenderer &) = delete;
+
+    /**
+     * Waits for in-flight meshing jobs
+     */
+    ~ChunkRenderer();
+
+    /**
+     * Queue meshing of dirty chunks, drop meshes of unloaded ones and upload
+     * finished meshes within the upload budget. GL thread only.
+     *
+     * @param world world::World&
+     */
+    void update(world::World &world);
+
+    /**
+     * Draw the chunk meshes inside the frustum as one batch, the shader
+     * program must be in use
+     *
+     * With visibility culling on, only chunks reachable from the camera's
+     * chunk through connected faces are drawn. Occlusion culling then drops
+     * the ones hidden behind opaque sections.
+     *
+     * @param shaderProgram opengl::ShaderProgram&
+     * @param viewProjection const glm::mat4&
+     * @param cameraPosition glm::vec3
+     */
+    void draw(opengl::ShaderProgram &shaderProgram,
+              const glm::mat4 &viewProjection, glm::vec3 cameraPosition);
+
+    std::size_t getMeshCount() const;
+
+    /**
+     * Number of meshes that passed culling in the last draw, not counting
+     * conditional draws left to the GPU
+     */
+    std::size_t getVisibleCount() const;
+
+    /**
+     * Toggle the walk through section visibility, on by default
+     *
+     * @param enabled bool
+     */
+    void setVisibilityCulling(bool enabled);
+    bool getVisibilityCulling() const;
+
+    /**
+     * @param mode OcclusionMode defaults to SOFTWARE
+     */
+    void setOcclusionMode(OcclusionMode mode);
+    OcclusionMode getOcclusionMode() const;
+
+    /**
+     * Choose how the batch is submitted, defaults to the best path the
+     * context supports
+     *
+     * @param path DrawPath
+     */
+    void setDrawPath(DrawPath path);
+    DrawPath getDrawPath() const;
+
+    /**
+     * Switch meshing algorithm, every chunk is remeshed on the next update
+     *
+     * @param mode MeshingMode
+     */
+    void setMeshingMode(MeshingMode mode);
+    MeshingMode getMeshingMode() const;
+
+    /**
+     * Limit the uploads done by a single update. At least one mesh is
+     * uploaded per update whatever the budget.
+     *
+     * @param bytes std::size_t
+     * @param milliseconds double
+     */
+    void setUploadBudget(std::size_t bytes, double milliseconds);
+
+    /**
+     * Number of chunks queued for meshing or upload
+     */
+    std::size_t getPendingCount() const;
+
+  private:
+    struct Entry {
+        glm::ivec3 position;
+        ChunkBufferPool::Handle mesh{ChunkBufferPool::INVALID_HANDLE};
+
+        // Only chunks with a mesh or occluders have a box to cull
+        FrustumCuller::Handle box{FrustumCuller::INVALID_HANDLE};
+
+        // Until meshed, assume the chunk can be seen through
+        SectionVisibility visibility{SectionVisibility::all()};
+
+        // Last frame the visibility walk reached this chunk
+        std::uint32_t visitedFrame{0};
+
+        // Opaque all around, see OcclusionCuller::isOccluder
+        bool occluder{false};
+
+        // Hardware occlusion state, the last answered query decides whether
+        // the chunk is in the batch
+        GLuint query{0};
+        bool queryPending{false};
+        bool occluded{false};
+
+        // Version of the latest remesh request, results of older requests
+        // are stale and dropped
+        std::uint64_t version{0};
+        bool pending{false};
+    };
+
+    struct MeshResult {
+        std::uint64_t key{0};
+        std::uint64_t version{0};
+        MeshData data;
+        SectionVisibility visibility;
+        bool occluder{false};
+    };
+
+    struct VisibilityStep {
+        Entry *entry;
+        glm::ivec3 position;
+
+        // Face the walk entered through, -1 for the camera's chunk
+        int from;
+
+        // Directions taken so far, the walk never turns back on one
+        std::uint8_t directions;
+    };
+
+    jobs::JobSystem &jobSystem;
+    jobs::JobHandle inFlight;
+
+    ChunkMesher mesher;
+    bool remeshAll{false};
+
+    // Shared by every entry, so an entry recreated after its chunk was
+    // unloaded never reuses a version an old job still carries
+    std::uint64_t nextVersion{0};
+
+    utils::MpscQueue<MeshResult> results;
+
+    std::size_t uploadBudgetBytes{8 * 1024 * 1024};
+    double uploadBudgetMilliseconds{2.0};
+
+    ChunkBufferPool pool;
+    std::unordered_map<std::uint64_t, Entry> meshes;
+
+    DrawPath drawPath;
+    std::vector<ChunkBufferPool::Handle> batch;
+
+    FrustumCuller culler;
+    std::vector<FrustumCuller::Handle> visible;
+
+    // Entry owning each culler box, indexed by box handle. Pointers into an
+    // unordered_map stay valid until the element is erased.
+    std::vector<Entry *> boxEntries;
+
+    bool visibilityCulling{true};
+    std::uint32_t frame{0};
+    std::vector<VisibilityStep> steps;
+
+    OcclusionMode occlusionMode{OcclusionMode::SOFTWARE};
+    OcclusionCuller occlusionCuller;
+    std::vector<Entry *> candidates;
+    std::vector<Entry *> occluders;
+
+    // Created on first use, it loads its own shaders
+    std::unique_ptr<OcclusionQueries> occlusionQueries;
+    std::vector<Entry *> conditional;
+
+    void upload(MeshResult &result);
+
+    /**
+     * Breadth first walk from the camera's chunk, marking the chunks it
+     * reaches with the current frame
+     *
+     * @return bool false when the camera isn't in a known chunk
+     */
+    bool walkVisibility(const Frustum &frustum, glm::vec3 cameraPosition);
+
+    /**
+     * Rasterize the occluders nearest to the camera among the frustum
+     * visible chunks
+     */
+    void renderOccluders(const glm::mat4 &viewProjection,
+                         glm::vec3 cameraPosition);
+
+    /**
+     * Draw the candidates the GPU last saw as visible, then query every
+     * candidate due for one. Candidates last seen occluded are drawn under
+     * conditional rendering on their newest query, still pending or not.
+     */
+    void drawWithQueries(opengl::ShaderProgram &shaderProgram,
+                         glm::vec3 cameraPosition);
+
+    /**
+     * Hand an entry's query back to the pool
+     */
+    void releaseQuery(Entry &entry);
+};
+
+} // namespace render
+
+} // namespace mine
+
+#endif
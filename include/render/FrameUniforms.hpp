@@ -0,0 +1,65 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_RENDER_INCLUDE_RENDER_FRAMEUNIFORMS_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_RENDER_INCLUDE_RENDER_FRAMEUNIFORMS_HPP
+
+#include "opengl/GLBuffer.hpp"
+#include "opengl/ShaderProgram.hpp"
+
+#include <glm/glm.hpp>
+
+namespace mine {
+
+namespace render {
+
+/**
+ * Per-frame values shared by every shader program, mirrors the std140
+ * `Frame` uniform block declared in the shaders
+ */
+struct FrameData {
+    glm::mat4 viewProjection;
+    glm::mat4 view;
+    glm::mat4 projection;
+
+    // xyz: camera position, w: unused
+    glm::vec4 cameraPosition;
+
+    // x: time in seconds, y: near plane, z: far plane, w: unused
+    glm::vec4 parameters;
+};
+
+static_assert(sizeof(FrameData) == 3 * 64 + 2 * 16,
+              "FrameData must match the std140 layout of the Frame block");
+
+/**
+ * Uniform buffer holding FrameData, written once per frame and bound to
+ * BINDING for all programs
+ */
+class FrameUniforms {
+  public:
+    static constexpr GLuint BINDING = 0;
+    static constexpr const char *BLOCK_NAME = "Frame";
+
+    FrameUniforms();
+
+    /**
+     * Point a program's Frame block at this buffer's binding
+     *
+     * @param shaderProgram opengl::ShaderProgram&
+     */
+    void attach(opengl::ShaderProgram &shaderProgram);
+
+    /**
+     * Upload this frame's values
+     *
+     * @param data const FrameData&
+     */
+    void update(const FrameData &data);
+
+  private:
+    opengl::GLBuffer buffer;
+};
+
+} // namespace render
+
+} // namespace mine
+
+#endif
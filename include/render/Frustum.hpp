@@ -0,0 +1,47 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_RENDER_INCLUDE_RENDER_FRUSTUM_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_RENDER_INCLUDE_RENDER_FRUSTUM_HPP
+
+#include <glm/glm.hpp>
+
+#include <array>
+
+namespace mine {
+
+namespace render {
+
+/**
+ * The six clipping planes of a view-projection matrix
+ *
+ * Planes are stored as (normal, distance) with normals pointing inwards, a
+ * point p is inside a plane when dot(normal, p) + distance >= 0.
+ */
+struct Frustum {
+    static constexpr int PLANE_COUNT = 6;
+
+    // Left, right, bottom, top, near, far
+    std::array<glm::vec4, PLANE_COUNT> planes;
+
+    /**
+     * Extract the planes of a projection * view matrix
+     *
+     * @param viewProjection const glm::mat4&
+     * @return Frustum
+     */
+    static Frustum fromMatrix(const glm::mat4 &viewProjection);
+
+    /**
+     * Whether an axis aligned box is at least partially inside. Boxes that
+     * straddle two planes outside a corner may pass, which is conservative.
+     *
+     * @param min glm::vec3
+     * @param max glm::vec3
+     * @return bool
+     */
+    bool intersects(glm::vec3 min, glm::vec3 max) const;
+};
+
+} // namespace render
+
+} // namespace mine
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_RENDER_INCLUDE_RENDER_FRUSTUMCULLER_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_RENDER_INCLUDE_RENDER_FRUSTUMCULLER_HPP
+
+#include "render/Frustum.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mine {
+
+namespace render {
+
+/**
+ * A set of axis aligned boxes tested against a frustum in bulk
+ *
+ * Boxes are kept densely packed as structure of arrays, so the test runs on
+ * four boxes at a time with SSE, or eight with AVX when the compiler targets
+ * it. Removal swaps the last box into the hole, callers refer to boxes by
+ * stable handles instead of positions.
+ */
+class FrustumCuller {
+  public:
+    using Handle = std::uint32_t;
+    static constexpr Handle INVALID_HANDLE = ~Handle{0};
+
+    /**
+     * @param min glm::vec3
+     * @param max glm::vec3
+     * @return Handle
+     */
+    Handle add(glm::vec3 min, glm::vec3 max);
+
+    /**
+     * Remove a box, INVALID_HANDLE is ignored
+     */
+    void remove(Handle handle);
+
+    /**
+     * Append the handles of every box intersecting the frustum to `visible`
+     *
+     * @param frustum const Frustum&
+     * @param visible std::vector<Handle>&
+     */
+    void cull(const Frustum &frustum, std::vector<Handle> &visible) const;
+
+    std::size_t size() const;
+
+  private:
+    std::vector<float> minX;
+    std::vector<float> minY;
+    std::vector<float> minZ;
+    std::vector<float> maxX;
+    std::vector<float> maxY;
+    std::vector<float> maxZ;
+
+    // Dense position -> handle and handle -> dense position
+    std::vector<Handle> handles;
+    std::vector<std::uint32_t> positions;
+    std::vector<Handle> freeHandles;
+};
+
+} // namespace render
+
+} // namespace mine
+
+#endif
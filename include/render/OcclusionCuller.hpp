@@ -0,0 +1,111 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_RENDER_INCLUDE_RENDER_OCCLUSIONCULLER_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_RENDER_INCLUDE_RENDER_OCCLUSIONCULLER_HPP
+
+#include "jobs/JobSystem.hpp"
+#include "render/ChunkMesher.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace mine {
+
+namespace render {
+
+/**
+ * Software occlusion culling against a small depth buffer
+ *
+ * Boxes known to be opaque are rasterized on the CPU into a WIDTH x HEIGHT
+ * depth buffer, split into bands of rows across the job system. A max depth
+ * pyramid (hierarchical Z) is then built from it, so testing a box only
+ * reads a handful of texels whatever its size on screen.
+ *
+ * Depth is NDC z remapped to [0, 1], rows go bottom to top like NDC y.
+ */
+class OcclusionCuller {
+  public:
+    static constexpr int WIDTH = 256;
+    static constexpr int HEIGHT = 128;
+
+    OcclusionCuller();
+
+    /**
+     * Whether a whole section can be rasterized as a solid box, that is
+     * every block on its boundary is opaque
+     *
+     * @param section const PaddedSection&
+     * @return bool
+     */
+    static bool isOccluder(const PaddedSection &section);
+
+    /**
+     * Drop the previous frame's occluders
+     *
+     * @param viewProjection const glm::mat4&
+     */
+    void begin(const glm::mat4 &viewProjection);
+
+    /**
+     * Queue an opaque box for rasterization, boxes crossing the near plane
+     * are ignored
+     *
+     * @param min glm::vec3
+     * @param max glm::vec3
+     */
+    void addOccluder(glm::vec3 min, glm::vec3 max);
+
+    /**
+     * Rasterize the queued occluders and build the depth pyramid
+     *
+     * @param jobSystem jobs::JobSystem&
+     */
+    void render(jobs::JobSystem &jobSystem);
+
+    /**
+     * Whether any part of a box could be in front of the occluders, boxes
+     * crossing the near plane are always visible
+     *
+     * @param min glm::vec3
+     * @param max glm::vec3
+     * @return bool
+     */
+    bool isVisible(glm::vec3 min, glm::vec3 max) const;
+
+    std::size_t getOccluderCount() const;
+
+    /**
+     * Full resolution depth, WIDTH * HEIGHT values row by row
+     */
+    const std::vector<float> &getDepth() const;
+
+  private:
+    // Screen space triangle, x and y in pixels, z in [0, 1]
+    struct Triangle {
+        glm::vec3 vertices[3];
+    };
+
+    struct Level {
+        int width;
+        int height;
+        std::vector<float> depth;
+    };
+
+    glm::mat4 viewProjection{1.0f};
+    std::vector<Triangle> triangles;
+    std::size_t occluderCount{0};
+
+    // levels[0] is the depth buffer, each next level holds the max of 2x2
+    // texels of the previous one
+    std::vector<Level> levels;
+
+    void rasterize(const Triangle &triangle, int firstRow, int lastRow);
+
+    void buildHierarchy();
+};
+
+} // namespace render
+
+} // namespace mine
+
+#endif
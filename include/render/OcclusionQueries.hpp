@@ -0,0 +1,93 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_RENDER_INCLUDE_RENDER_OCCLUSIONQUERIES_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_RENDER_INCLUDE_RENDER_OCCLUSIONQUERIES_HPP
+
+#include "opengl/ShaderProgram.hpp"
+#include "opengl/VertexArray.hpp"
+#include "opengl/gl_includes.hpp"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+namespace mine {
+
+namespace render {
+
+/**
+ * Hardware occlusion queries on bounding boxes
+ *
+ * Boxes are drawn against the depth buffer with color and depth writes off,
+ * each inside a GL_ANY_SAMPLES_PASSED query. Results are only ever polled,
+ * callers use the previous frame's answer or conditional rendering so the
+ * CPU never waits on the GPU.
+ */
+class OcclusionQueries {
+  public:
+    OcclusionQueries();
+
+    OcclusionQueries(const OcclusionQueries &) = delete;
+    OcclusionQueries &operator=(const OcclusionQueries &) = delete;
+
+    /**
+     * Deletes every query created, released or not
+     */
+    ~OcclusionQueries();
+
+    /**
+     * Get an unused query object
+     *
+     * @return GLuint
+     */
+    GLuint acquire();
+
+    /**
+     * Return a query object to the pool, 0 is ignored
+     */
+    void release(GLuint query);
+
+    /**
+     * Set up the state to draw query boxes, until end()
+     */
+    void begin();
+
+    /**
+     * Draw a box inside a query, between begin() and end()
+     *
+     * @param query GLuint
+     * @param min glm::vec3
+     * @param max glm::vec3
+     */
+    void query(GLuint query, glm::vec3 min, glm::vec3 max);
+
+    /**
+     * Restore color and depth writes and face culling
+     */
+    void end();
+
+    /**
+     * Read a query's result if the GPU has it
+     *
+     * @param query GLuint
+     * @param visible bool& set when the result is available
+     * @return bool whether the result was available
+     */
+    static bool poll(GLuint query, bool &visible);
+
+  private:
+    opengl::ShaderProgram program;
+    opengl::Uniform boxMin;
+    opengl::Uniform boxSize;
+
+    opengl::VertexArray cube;
+
+    std::vector<GLuint> queries;
+    std::vector<GLuint> freeQueries;
+
+    bool cullFace{false};
+};
+
+} // namespace render
+
+} // namespace mine
+
+#endif
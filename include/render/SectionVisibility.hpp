@@ -0,0 +1,63 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_RENDER_INCLUDE_RENDER_SECTIONVISIBILITY_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_RENDER_INCLUDE_RENDER_SECTIONVISIBILITY_HPP
+
+#include "render/ChunkMesher.hpp"
+
+#include <cstdint>
+
+namespace mine {
+
+namespace render {
+
+/**
+ * Which faces of a chunk section can see each other through its transparent
+ * blocks
+ *
+ * Faces are numbered like the mesher's face normals: -X, +X, -Y, +Y, -Z, +Z.
+ * Two faces are connected when a single pocket of transparent blocks touches
+ * both, which is all a visibility walk needs to know to go through the
+ * section.
+ */
+class SectionVisibility {
+  public:
+    static constexpr int FACE_COUNT = 6;
+
+    /**
+     * Every face connected to every other, what an empty section has
+     */
+    static SectionVisibility all();
+
+    /**
+     * Flood fill the section's transparent blocks and record the faces each
+     * pocket touches
+     *
+     * @param section const PaddedSection&
+     * @return SectionVisibility
+     */
+    static SectionVisibility compute(const PaddedSection &section);
+
+    /**
+     * Face on the other side of the section
+     */
+    static int opposite(int face) { return face ^ 1; }
+
+    bool isConnected(int from, int to) const {
+        return (this->bits >> (from * FACE_COUNT + to)) & 1;
+    }
+
+    void connect(int from, int to) {
+        this->bits |= std::uint64_t{1} << (from * FACE_COUNT + to);
+        this->bits |= std::uint64_t{1} << (to * FACE_COUNT + from);
+    }
+
+    std::uint64_t getBits() const { return this->bits; }
+
+  private:
+    std::uint64_t bits{0};
+};
+
+} // namespace render
+
+} // namespace mine
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_UTILS_INCLUDE_UTILS_MPSCQUEUE_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_UTILS_INCLUDE_UTILS_MPSCQUEUE_HPP
+
+#include <atomic>
+#include <utility>
+
+namespace mine {
+
+namespace utils {
+
+/**
+ * Unbounded lock-free multi-producer single-consumer queue
+ *
+ * Any thread may push, only one thread at a time may pop. Producers only
+ * ever swap the head pointer, so pushing never blocks. A push that is halfway
+ * done may briefly hide the elements queued after it from the consumer.
+ *
+ * T must be default constructible and movable.
+ */
+template <typename T> class MpscQueue {
+  public:
+    MpscQueue() : head{new Node{}} { this->tail = this->head.load(); }
+
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue &operator=(const MpscQueue &) = delete;
+
+    ~MpscQueue() {
+        T discarded;
+        while (this->pop(discarded)) {
+        }
+
+        delete this->tail;
+    }
+
+    void push(T value) {
+        Node *node{new Node{}};
+        node->value = std::move(value);
+
+        Node *previous{this->head.exchange(node, std::memory_order_acq_rel)};
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    /**
+     * Pop the oldest element, consumer thread only
+     *
+     * @param out T& receives the element
+     * @return bool false if the queue was empty
+     */
+    bool pop(T &out) {
+        Node *next{this->tail->next.load(std::memory_order_acquire)};
+        if (!next) {
+            return false;
+        }
+
+        // `next` becomes the new sentinel once its value is moved out
+        out = std::move(next->value);
+
+        delete this->tail;
+        this->tail = next;
+
+        return true;
+    }
+
+    bool empty() const {
+        return !this->tail->next.load(std::memory_order_acquire);
+    }
+
+  private:
+    struct Node {
+        std::atomic<Node *> next{nullptr};
+        T value{};
+    };
+
+    std::atomic<Node *> head;
+    Node *tail;
+};
+
+} // namespace utils
+
+} // namespace mine
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_UTILS_INCLUDE_UTILS_PROFILER_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_UTILS_INCLUDE_UTILS_PROFILER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mine {
+
+namespace utils {
+
+/**
+ * Timed zones of every thread, exported as a Chrome trace
+ *
+ * Each thread records into its own ring buffer, so recording takes no lock
+ * and never waits on another thread. A ring keeps the last CAPACITY zones of
+ * its thread, older ones are overwritten. Disabled by default, zones then
+ * cost a relaxed load.
+ */
+class Profiler {
+  public:
+    static constexpr std::size_t CAPACITY = 1 << 16;
+
+    /**
+     * A timeline of zones, every thread records on its own
+     */
+    struct Track;
+
+    static Profiler &get();
+
+    Profiler(const Profiler &) = delete;
+    Profiler &operator=(const Profiler &) = delete;
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    /**
+     * Label the calling thread in traces, costs nothing until the thread
+     * records a zone
+     *
+     * @param name std::string
+     */
+    void setThreadName(std::string name);
+
+    /**
+     * Nanoseconds since the profiler was created
+     */
+    std::uint64_t now() const;
+
+    /**
+     * Record a finished zone on the calling thread
+     *
+     * @param name const char* must outlive the profiler, e.g. a literal,
+     * and be plain text as it's written to the trace unescaped
+     * @param start std::uint64_t from now()
+     * @param end std::uint64_t from now()
+     */
+    void record(const char *name, std::uint64_t start, std::uint64_t end);
+
+    /**
+     * A timeline not tied to a thread, e.g. for GPU work, lives as long as
+     * the profiler
+     *
+     * @param name std::string
+     * @return Track&
+     */
+    Track &addTrack(std::string name);
+
+    /**
+     * Record a finished zone on a track, one thread at a time
+     */
+    void record(Track &track, const char *name, std::uint64_t start,
+                std::uint64_t end);
+
+    /**
+     * Write every thread's zones in Chrome's trace event format, for
+     * chrome://tracing or Perfetto. Safe while other threads keep recording.
+     *
+     * @param path const char*
+     * @return bool false if the file couldn't be written
+     */
+    bool writeChromeTrace(const char *path);
+
+  private:
+    Profiler();
+
+    std::atomic<bool> enabled{false};
+    std::int64_t epoch;
+
+    // Guards adding and naming tracks, never taken to record
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Track>> tracks;
+
+    // Registered on the thread's first zone
+    static thread_local Track *current;
+
+    Track &threadTrack();
+};
+
+/**
+ * Times its own lifetime as a zone of the current thread
+ */
+class ProfileZone {
+  public:
+    /**
+     * @param name const char* must outlive the profiler, e.g. a literal
+     */
+    explicit ProfileZone(const char *name);
+    ~ProfileZone();
+
+    ProfileZone(const ProfileZone &) = delete;
+    ProfileZone &operator=(const ProfileZone &) = delete;
+
+  private:
+    const char *name;
+    std::uint64_t start;
+    bool active;
+};
+
+} // namespace utils
+
+} // namespace mine
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_UTILS_INCLUDE_UTILS_RANGEALLOCATOR_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_UTILS_INCLUDE_UTILS_RANGEALLOCATOR_HPP
+
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <set>
+#include <utility>
+
+namespace mine {
+
+namespace utils {
+
+/**
+ * Bookkeeping for carving ranges out of a fixed size space, e.g. a large GPU
+ * buffer. It only tracks offsets and never touches the memory itself.
+ *
+ * Free ranges are kept both by offset (to merge neighbours when freeing) and
+ * by size (for best-fit allocation), so both operations are O(log n).
+ */
+class RangeAllocator {
+  public:
+    RangeAllocator(std::size_t capacity = 0);
+
+    /**
+     * Reserve `size` units, using the smallest free range that fits
+     *
+     * @param size std::size_t must not be zero
+     * @return std::optional<std::size_t> the offset, or nothing if no free
+     * range is large enough
+     */
+    std::optional<std::size_t> allocate(std::size_t size);
+
+    /**
+     * Release a range returned by allocate(), merging it with free neighbours
+     *
+     * @param offset std::size_t
+     * @param size std::size_t the size passed to allocate()
+     */
+    void free(std::size_t offset, std::size_t size);
+
+    /**
+     * Free everything and change capacity
+     */
+    void reset(std::size_t capacity);
+
+    std::size_t getCapacity() const;
+    std::size_t getUsed() const;
+    std::size_t getLargestFree() const;
+
+    /**
+     * 0 when all free space is one contiguous range, approaching 1 as it gets
+     * split into small pieces
+     */
+    float getFragmentation() const;
+
+  private:
+    std::size_t capacity;
+    std::size_t used{0};
+
+    std::map<std::size_t, std::size_t> byOffset;
+
+    // Ordered by size then offset, so a range is found directly when erased
+    std::set<std::pair<std::size_t, std::size_t>> bySize;
+
+    void insertFree(std::size_t offset, std::size_t size);
+    void eraseFree(std::map<std::size_t, std::size_t>::iterator it);
+};
+
+} // namespace utils
+
+} // namespace mine
+
+#endif
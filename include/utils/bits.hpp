@@ -0,0 +1,77 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_UTILS_INCLUDE_UTILS_BITS_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_UTILS_INCLUDE_UTILS_BITS_HPP
+
+#include <cstdint>
+
+namespace mine {
+
+namespace utils {
+
+namespace bits {
+
+/**
+ * Index of the lowest set bit, `value` must not be zero
+ *
+ * @param value std::uint32_t
+ * @return int
+ */
+inline int countTrailingZeros(std::uint32_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(value);
+#else
+    int count{0};
+    while (!(value & 1)) {
+        value >>= 1;
+        count++;
+    }
+
+    return count;
+#endif
+}
+
+/**
+ * Index of the lowest set bit, `value` must not be zero
+ *
+ * @param value std::uint64_t
+ * @return int
+ */
+inline int countTrailingZeros(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(value);
+#else
+    int count{0};
+    while (!(value & 1)) {
+        value >>= 1;
+        count++;
+    }
+
+    return count;
+#endif
+}
+
+/**
+ * Number of set bits
+ *
+ * @param value std::uint64_t
+ * @return int
+ */
+inline int popCount(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(value);
+#else
+    int count{0};
+    for (; value; value &= value - 1) {
+        count++;
+    }
+
+    return count;
+#endif
+}
+
+} // namespace bits
+
+} // namespace utils
+
+} // namespace mine
+
+#endif
@@ -1,7 +1,9 @@
 #ifndef KASOUZA_MINECRAFT_INCLUDE_UTILS_INCLUDE_UTILS_FS_HPP
 #define KASOUZA_MINECRAFT_INCLUDE_UTILS_INCLUDE_UTILS_FS_HPP
 
+#include <cstddef>
 #include <string>
+#include <vector>
 
 namespace mine {
 
@@ -17,6 +19,26 @@ namespace fs {
  */
 std::string readFile(const char *path);
 
+/**
+ * Read a whole file as bytes
+ *
+ * @param path const char*
+ * @param out std::vector<unsigned char>& replaced by the contents
+ * @return bool false if the file couldn't be read, `out` is then untouched
+ */
+bool readBinaryFile(const char *path, std::vector<unsigned char> &out);
+
+/**
+ * Replace a file's contents, the file is written next to its destination
+ * and renamed so readers never see it half written
+ *
+ * @param path const char*
+ * @param data const void*
+ * @param size std::size_t
+ * @return bool
+ */
+bool writeBinaryFile(const char *path, const void *data, std::size_t size);
+
 } // namespace fs
 
 } // namespace utils
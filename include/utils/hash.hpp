@@ -0,0 +1,51 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_UTILS_INCLUDE_UTILS_HASH_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_UTILS_INCLUDE_UTILS_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace mine {
+
+namespace utils {
+
+namespace hash {
+
+constexpr std::uint64_t FNV_OFFSET = 14695981039346656037ull;
+constexpr std::uint64_t FNV_PRIME = 1099511628211ull;
+
+/**
+ * 64-bit FNV-1a of some bytes, chain calls by passing the previous result
+ * as `hash`
+ *
+ * @param data const void*
+ * @param size std::size_t
+ * @param hash std::uint64_t
+ * @return std::uint64_t
+ */
+inline std::uint64_t hashBytes(const void *data, std::size_t size,
+                               std::uint64_t hash = FNV_OFFSET) {
+    const unsigned char *bytes{static_cast<const unsigned char *>(data)};
+    for (std::size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
+
+/**
+ * hashBytes() of a string's characters
+ */
+inline std::uint64_t hashString(std::string_view text,
+                                std::uint64_t hash = FNV_OFFSET) {
+    return hashBytes(text.data(), text.size(), hash);
+}
+
+} // namespace hash
+
+} // namespace utils
+
+} // namespace mine
+
+#endif
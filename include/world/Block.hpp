@@ -0,0 +1,55 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_WORLD_INCLUDE_WORLD_BLOCK_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_WORLD_INCLUDE_WORLD_BLOCK_HPP
+
+#include <cstdint>
+
+namespace mine {
+
+namespace world {
+
+/**
+ * Numeric block identifier, as stored in chunk section palettes
+ */
+using BlockId = std::uint16_t;
+
+namespace blocks {
+
+constexpr BlockId AIR = 0;
+constexpr BlockId STONE = 1;
+constexpr BlockId DIRT = 2;
+constexpr BlockId GRASS = 3;
+
+} // namespace blocks
+
+/**
+ * Whether neighbouring faces can be seen through this block
+ *
+ * @param block BlockId
+ * @return bool
+ */
+inline bool isTransparent(BlockId block) { return block == blocks::AIR; }
+
+/**
+ * Layer of the block texture array used by every face of this block
+ *
+ * @param block BlockId must not be transparent
+ * @return unsigned int
+ */
+inline unsigned int textureLayer(BlockId block) {
+    return static_cast<unsigned int>(block - 1) & 0xff;
+}
+
+/**
+ * Image of each block texture layer, in layer order
+ */
+constexpr const char *TEXTURE_FILES[]{
+    "stone.png",
+    "dirt.png",
+    "grass.png",
+};
+
+} // namespace world
+
+} // namespace mine
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_WORLD_INCLUDE_WORLD_CHUNK_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_WORLD_INCLUDE_WORLD_CHUNK_HPP
+
+#include "world/ChunkSection.hpp"
+
+#include <glm/vec3.hpp>
+
+namespace mine {
+
+namespace world {
+
+/**
+ * A cubic chunk of the world
+ *
+ * Chunks are indexed by chunk coordinates, i.e. world block coordinates
+ * divided by ChunkSection::SIZE.
+ */
+class Chunk {
+  public:
+    static constexpr int SIZE = ChunkSection::SIZE;
+
+    Chunk(glm::ivec3 position, BlockId fill = blocks::AIR);
+
+    BlockId getBlock(int x, int y, int z) const {
+        return this->section.getBlock(x, y, z);
+    }
+
+    void setBlock(int x, int y, int z, BlockId block);
+
+    glm::ivec3 getPosition() const;
+
+    /**
+     * World position of the block at local (0, 0, 0)
+     */
+    glm::ivec3 getOrigin() const;
+
+    ChunkSection &getSection();
+    const ChunkSection &getSection() const;
+
+    bool isDirty() const;
+    void markDirty();
+    void clearDirty();
+
+  private:
+    glm::ivec3 position;
+    ChunkSection section;
+    bool dirty{true};
+};
+
+/**
+ * Chunk coordinate containing a world block coordinate
+ */
+inline int toChunkCoord(int blockCoord) {
+    // Arithmetic shift floors negative coordinates too
+    return blockCoord >> 4;
+}
+
+/**
+ * Local (in-chunk) coordinate of a world block coordinate
+ */
+inline int toLocalCoord(int blockCoord) {
+    return blockCoord & (Chunk::SIZE - 1);
+}
+
+static_assert(Chunk::SIZE == 16, "toChunkCoord assumes 16 block chunks");
+
+} // namespace world
+
+} // namespace mine
+
+#endif
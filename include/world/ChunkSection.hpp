@@ -0,0 +1,113 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_WORLD_INCLUDE_WORLD_CHUNKSECTION_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_WORLD_INCLUDE_WORLD_CHUNKSECTION_HPP
+
+#include "world/Block.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace mine {
+
+namespace world {
+
+/**
+ * A 16x16x16 cube of blocks
+ *
+ * Blocks are stored as bit-packed indices into a per-section palette. A
+ * section made of a single block (all air, all stone...) keeps only its
+ * palette and no index data at all.
+ */
+class ChunkSection {
+  public:
+    static constexpr int SIZE = 16;
+    static constexpr int AREA = SIZE * SIZE;
+    static constexpr int VOLUME = SIZE * SIZE * SIZE;
+
+    ChunkSection(BlockId fill = blocks::AIR);
+
+    BlockId getBlock(int x, int y, int z) const {
+        assert(inBounds(x, y, z));
+
+        if (this->bits == 0) {
+            return this->palette[0];
+        }
+
+        return this->palette[this->getIndex(blockIndex(x, y, z))];
+    }
+
+    void setBlock(int x, int y, int z, BlockId block);
+
+    /**
+     * Replace every block in the section, dropping back to the single-value
+     * representation
+     */
+    void fill(BlockId block);
+
+    /**
+     * Drop palette entries that are no longer referenced, shrinking the
+     * index width (or going back to a single value) when possible
+     */
+    void compact();
+
+    /**
+     * Whether every block in the section is the same
+     */
+    bool isUniform() const { return this->bits == 0; }
+
+    bool isEmpty() const { return this->nonAirCount == 0; }
+
+    int getNonAirCount() const { return this->nonAirCount; }
+
+    int getBitsPerBlock() const { return this->bits; }
+
+    const std::vector<BlockId> &getPalette() const { return this->palette; }
+
+    /**
+     * Approximate heap memory used by the section's block data, in bytes
+     */
+    std::size_t memoryUsage() const;
+
+    static bool inBounds(int x, int y, int z) {
+        return x >= 0 && x < SIZE && y >= 0 && y < SIZE && z >= 0 && z < SIZE;
+    }
+
+    /**
+     * Linear block index, laid out as y-major, then z, then x
+     */
+    static int blockIndex(int x, int y, int z) {
+        return (y * SIZE + z) * SIZE + x;
+    }
+
+  private:
+    std::vector<BlockId> palette;
+    std::vector<std::uint64_t> data;
+
+    int bits{0};
+    int nonAirCount{0};
+
+    // Index widths are powers of two so entries never straddle two words,
+    // which turns the word/offset math into shifts and masks
+    int bitsShift{0};
+    int wordShift{0};
+    std::uint64_t mask{0};
+
+    unsigned int getIndex(int index) const {
+        std::uint64_t word{this->data[index >> this->wordShift]};
+        int offset{(index & ((1 << this->wordShift) - 1)) << this->bitsShift};
+
+        return static_cast<unsigned int>((word >> offset) & this->mask);
+    }
+
+    void setIndex(int index, unsigned int value);
+
+    unsigned int findOrAddPalette(BlockId block);
+
+    void resize(int newBits);
+};
+
+} // namespace world
+
+} // namespace mine
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_WORLD_INCLUDE_WORLD_TERRAINGENERATOR_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_WORLD_INCLUDE_WORLD_TERRAINGENERATOR_HPP
+
+#include "jobs/JobSystem.hpp"
+#include "world/World.hpp"
+
+#include <cstdint>
+
+namespace mine {
+
+namespace world {
+
+/**
+ * Deterministic heightmap terrain, the same seed always yields the same world
+ */
+class TerrainGenerator {
+  public:
+    TerrainGenerator(std::uint32_t seed = 0);
+
+    /**
+     * Fill a chunk with terrain
+     */
+    void generate(Chunk &chunk) const;
+
+    /**
+     * Load and generate every chunk in [from, to)
+     */
+    void generate(World &world, glm::ivec3 from, glm::ivec3 to) const;
+
+    /**
+     * Load every chunk in [from, to) and generate them on the job system
+     */
+    void generate(World &world, glm::ivec3 from, glm::ivec3 to,
+                  jobs::JobSystem &jobSystem) const;
+
+    /**
+     * Terrain surface height at a world column
+     */
+    int heightAt(int x, int z) const;
+
+  private:
+    std::uint32_t seed;
+
+    float noise(float x, float z) const;
+};
+
+} // namespace world
+
+} // namespace mine
+
+#endif
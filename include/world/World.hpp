@@ -0,0 +1,129 @@
+#ifndef KASOUZA_MINECRAFT_INCLUDE_WORLD_INCLUDE_WORLD_WORLD_HPP
+#define KASOUZA_MINECRAFT_INCLUDE_WORLD_INCLUDE_WORLD_WORLD_HPP
+
+#include "world/Chunk.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace mine {
+
+namespace world {
+
+/**
+ * Pack a chunk coordinate into a 64-bit key, 21 bits per axis
+ *
+ * @param position glm::ivec3
+ * @return std::uint64_t
+ */
+inline std::uint64_t packChunkKey(glm::ivec3 position) {
+    constexpr std::uint64_t mask{(std::uint64_t{1} << 21) - 1};
+
+    return (static_cast<std::uint64_t>(position.x) & mask) |
+           ((static_cast<std::uint64_t>(position.y) & mask) << 21) |
+           ((static_cast<std::uint64_t>(position.z) & mask) << 42);
+}
+
+/**
+ * Owner of every loaded chunk
+ *
+ * Chunks live in a flat open-addressing (linear probing) hash table keyed by
+ * their packed chunk coordinate. The last chunk found is remembered, so runs
+ * of block lookups inside the same chunk skip the table entirely. Because of
+ * that cache, lookups are not safe to run concurrently with each other.
+ */
+class World {
+  public:
+    World();
+
+    World(const World &) = delete;
+    World &operator=(const World &) = delete;
+
+    /**
+     * The moved-from world is left empty but usable
+     */
+    World(World &&other);
+    World &operator=(World &&other);
+
+    /**
+     * Get the chunk at a chunk coordinate, or nullptr if it isn't loaded
+     */
+    Chunk *getChunk(glm::ivec3 position) const {
+        std::uint64_t key{packChunkKey(position)};
+        if (this->lastChunk && this->lastKey == key) {
+            return this->lastChunk;
+        }
+
+        return this->findChunk(key);
+    }
+
+    /**
+     * Get the chunk at a chunk coordinate, creating it if needed
+     */
+    Chunk &loadChunk(glm::ivec3 position, BlockId fill = blocks::AIR);
+
+    /**
+     * Unload the chunk at a chunk coordinate
+     *
+     * @return bool whether a chunk was unloaded
+     */
+    bool unloadChunk(glm::ivec3 position);
+
+    /**
+     * Get a block by world position, unloaded chunks read as air
+     */
+    BlockId getBlock(glm::ivec3 position) const {
+        Chunk *chunk{this->getChunk({toChunkCoord(position.x),
+                                     toChunkCoord(position.y),
+                                     toChunkCoord(position.z)})};
+        if (!chunk) {
+            return blocks::AIR;
+        }
+
+        return chunk->getBlock(toLocalCoord(position.x),
+                               toLocalCoord(position.y),
+                               toLocalCoord(position.z));
+    }
+
+    /**
+     * Set a block by world position, loading its chunk if needed
+     *
+     * Neighbouring chunks sharing a face with the block are marked dirty too,
+     * since their meshes may need to reveal or hide a face.
+     */
+    void setBlock(glm::ivec3 position, BlockId block);
+
+    void forEachChunk(const std::function<void(Chunk &)> &callback);
+
+    std::size_t size() const;
+    std::size_t capacity() const;
+
+  private:
+    struct Slot {
+        std::uint64_t key{0};
+        std::unique_ptr<Chunk> chunk;
+    };
+
+    std::vector<Slot> slots;
+    std::size_t count{0};
+
+    mutable std::uint64_t lastKey{0};
+    mutable Chunk *lastChunk{nullptr};
+
+    Chunk *findChunk(std::uint64_t key) const;
+
+    std::size_t findSlot(std::uint64_t key) const;
+
+    void grow();
+};
+
+} // namespace world
+
+} // namespace mine
+
+#endif
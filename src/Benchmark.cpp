@@ -0,0 +1,119 @@
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace mine {
+
+namespace {
+
+std::string quote(const std::string &text) {
+    std::string quoted{"\""};
+
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            quoted += '\\';
+        }
+
+        // Control characters can't appear in JSON strings
+        quoted += static_cast<unsigned char>(c) < 0x20 ? ' ' : c;
+    }
+
+    return quoted + "\"";
+}
+
+std::string number(double value) {
+    std::ostringstream text;
+    text.precision(10);
+    text << value;
+
+    return text.str();
+}
+
+} // namespace
+
+std::size_t Benchmark::addSeries(std::string name) {
+    this->series.push_back({std::move(name), {}});
+    return this->series.size() - 1;
+}
+
+void Benchmark::reserve(std::size_t samples) {
+    for (Series &series : this->series) {
+        series.samples.reserve(samples);
+    }
+}
+
+void Benchmark::record(std::size_t series, double value) {
+    this->series[series].samples.push_back(value);
+}
+
+void Benchmark::setInfo(const std::string &key, const std::string &value) {
+    this->info.emplace_back(key, quote(value));
+}
+
+void Benchmark::setInfo(const std::string &key, double value) {
+    this->info.emplace_back(key, number(value));
+}
+
+Benchmark::Summary Benchmark::summarize(std::vector<double> samples) {
+    Summary summary;
+    if (samples.empty()) {
+        return summary;
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    double total{0.0};
+    for (double sample : samples) {
+        total += sample;
+    }
+
+    auto percentile{[&samples](double p) {
+        std::size_t rank{static_cast<std::size_t>(
+            std::ceil(p * static_cast<double>(samples.size())))};
+
+        return samples[std::max<std::size_t>(rank, 1) - 1];
+    }};
+
+    summary.mean = total / static_cast<double>(samples.size());
+    summary.p50 = percentile(0.50);
+    summary.p95 = percentile(0.95);
+    summary.p99 = percentile(0.99);
+    summary.max = samples.back();
+
+    return summary;
+}
+
+bool Benchmark::writeJson(const char *path) const {
+    std::ofstream file{path};
+    if (file.fail()) {
+        return false;
+    }
+
+    file << "{\n  \"info\": {";
+    for (std::size_t i = 0; i < this->info.size(); i++) {
+        file << (i ? ",\n" : "\n") << "    " << quote(this->info[i].first)
+             << ": " << this->info[i].second;
+    }
+    file << "\n  },\n  \"series\": {";
+
+    for (std::size_t i = 0; i < this->series.size(); i++) {
+        const Series &series{this->series[i]};
+        Summary summary{summarize(series.samples)};
+
+        file << (i ? ",\n" : "\n") << "    " << quote(series.name) << ": {"
+             << "\"samples\": " << series.samples.size()
+             << ", \"mean\": " << number(summary.mean)
+             << ", \"p50\": " << number(summary.p50)
+             << ", \"p95\": " << number(summary.p95)
+             << ", \"p99\": " << number(summary.p99)
+             << ", \"max\": " << number(summary.max) << "}";
+    }
+    file << "\n  }\n}\n";
+
+    return !file.fail();
+}
+
+} // namespace mine
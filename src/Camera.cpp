@@ -67,6 +67,12 @@ void Camera::handleMouseMovement(glm::vec2 cursorPos, float dt) {
 
 void Camera::setPosition(glm::vec3 position) { this->eye = position; }
 
+glm::vec3 Camera::getPosition() const { return this->eye; }
+
+void Camera::lookAt(glm::vec3 target) {
+    this->front = glm::normalize(target - this->eye);
+}
+
 glm::mat4 Camera::calculateLookAtMatrix() {
     glm::vec3 center{this->eye + this->front};
     return glm::lookAt(this->eye, center, this->up);
@@ -0,0 +1,91 @@
+#include "Flythrough.hpp"
+#include "utils/fs.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace mine {
+
+namespace {
+
+glm::vec3 catmullRom(glm::vec3 p0, glm::vec3 p1, glm::vec3 p2, glm::vec3 p3,
+                     float t) {
+    float t2{t * t};
+    float t3{t2 * t};
+
+    return 0.5f * (2.0f * p1 + (p2 - p0) * t +
+                   (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 +
+                   (3.0f * p1 - p0 - 3.0f * p2 + p3) * t3);
+}
+
+} // namespace
+
+Flythrough::Flythrough(std::vector<Keyframe> keyframes)
+    : keyframes{std::move(keyframes)} {
+    assert(this->keyframes.size() >= 2);
+}
+
+Flythrough Flythrough::fromFile(const char *path) {
+    std::istringstream file{utils::fs::readFile(path)};
+    std::vector<Keyframe> keyframes;
+
+    std::string line;
+    for (int number = 1; std::getline(file, line); number++) {
+        std::size_t start{line.find_first_not_of(" \t\r")};
+        if (start == std::string::npos || line[start] == '#') {
+            continue;
+        }
+
+        std::istringstream values{line};
+        Keyframe keyframe;
+
+        if (!(values >> keyframe.position.x >> keyframe.position.y >>
+              keyframe.position.z >> keyframe.target.x >> keyframe.target.y >>
+              keyframe.target.z)) {
+            std::cerr << "Malformed keyframe in " << path << ":" << number
+                      << std::endl;
+            exit(1);
+        }
+
+        keyframes.push_back(keyframe);
+    }
+
+    if (keyframes.size() < 2) {
+        std::cerr << "A flythrough needs at least two keyframes: " << path
+                  << std::endl;
+        exit(1);
+    }
+
+    return Flythrough{std::move(keyframes)};
+}
+
+Flythrough::Keyframe Flythrough::sample(float t) const {
+    int last{static_cast<int>(this->keyframes.size()) - 1};
+
+    float position{std::clamp(t, 0.0f, 1.0f) * static_cast<float>(last)};
+    int segment{std::min(static_cast<int>(position), last - 1)};
+    float local{position - static_cast<float>(segment)};
+
+    // The end keyframes stand in for their missing neighbours
+    const Keyframe &k0{this->keyframes[std::max(segment - 1, 0)]};
+    const Keyframe &k1{this->keyframes[segment]};
+    const Keyframe &k2{this->keyframes[segment + 1]};
+    const Keyframe &k3{this->keyframes[std::min(segment + 2, last)]};
+
+    return {
+        catmullRom(k0.position, k1.position, k2.position, k3.position, local),
+        catmullRom(k0.target, k1.target, k2.target, k3.target, local),
+    };
+}
+
+void Flythrough::apply(Camera &camera, float t) const {
+    Keyframe keyframe{this->sample(t)};
+
+    camera.setPosition(keyframe.position);
+    camera.lookAt(keyframe.target);
+}
+
+} // namespace mine
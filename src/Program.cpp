@@ -4,8 +4,9 @@
 
 namespace mine {
 
-Program::Program(const char *title, int width, int height)
-    : running{true}, window{title, width, height} {
+Program::Program(const char *title, int width, int height,
+                 opengl::WindowMode mode)
+    : running{true}, window{title, width, height, mode} {
     this->window.setFramebufferSizeCallback(
         [](GLFWwindow *, int newWidth, int newHeight) {
             glViewport(0, 0, newWidth, newHeight);
@@ -0,0 +1,206 @@
+#include "jobs/JobSystem.hpp"
+#include "utils/Profiler.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+
+namespace mine {
+
+namespace jobs {
+
+namespace {
+
+// Lets jobs submitted from a worker land on that worker's own deque
+thread_local const JobSystem *currentSystem{nullptr};
+thread_local int currentWorker{-1};
+
+} // namespace
+
+JobHandle::JobHandle() : pending{std::make_shared<std::atomic<int>>(0)} {}
+
+bool JobHandle::isDone() const {
+    return this->pending->load(std::memory_order_acquire) == 0;
+}
+
+JobSystem::JobSystem(unsigned int workerCount) {
+    workerCount = std::max(workerCount, 1u);
+
+    for (unsigned int i = 0; i < workerCount; i++) {
+        this->workers.emplace_back(std::make_unique<Worker>());
+    }
+
+    // Start threads only once every deque exists, they steal from each other
+    for (unsigned int i = 0; i < workerCount; i++) {
+        this->workers[i]->thread =
+            std::thread{&JobSystem::workerLoop, this, static_cast<int>(i)};
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock{this->sleepMutex};
+        this->running = false;
+    }
+    this->wakeUp.notify_all();
+
+    for (auto &worker : this->workers) {
+        worker->thread.join();
+    }
+}
+
+JobHandle JobSystem::submit(Job job, Priority priority) {
+    JobHandle handle;
+    this->submit(std::move(job), handle, priority);
+
+    return handle;
+}
+
+void JobSystem::submit(Job job, JobHandle &group, Priority priority) {
+    group.pending->fetch_add(1, std::memory_order_relaxed);
+    this->push({std::move(job), group.pending}, priority);
+}
+
+void JobSystem::wait(const JobHandle &handle) {
+    int self{currentSystem == this ? currentWorker : -1};
+
+    while (!handle.isDone()) {
+        if (!this->runOne(self)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::parallelFor(std::size_t count,
+                            const std::function<void(std::size_t)> &callback,
+                            Priority priority) {
+    // A few batches per worker keeps stealing balanced without paying a
+    // queue round trip per index
+    std::size_t batches{std::min<std::size_t>(
+        count, (this->workers.size() + 1) * 4)};
+    if (batches == 0) {
+        return;
+    }
+
+    std::size_t batchSize{(count + batches - 1) / batches};
+
+    JobHandle group;
+    for (std::size_t begin = 0; begin < count; begin += batchSize) {
+        std::size_t end{std::min(begin + batchSize, count)};
+
+        this->submit(
+            [&callback, begin, end]() {
+                for (std::size_t i = begin; i < end; i++) {
+                    callback(i);
+                }
+            },
+            group, priority);
+    }
+
+    this->wait(group);
+}
+
+unsigned int JobSystem::getWorkerCount() const {
+    return static_cast<unsigned int>(this->workers.size());
+}
+
+unsigned int JobSystem::defaultWorkerCount() {
+    unsigned int threads{std::thread::hardware_concurrency()};
+    return threads > 1 ? threads - 1 : 1;
+}
+
+void JobSystem::push(Task task, Priority priority) {
+    std::size_t index;
+    if (currentSystem == this) {
+        index = static_cast<std::size_t>(currentWorker);
+    } else {
+        index = this->nextWorker.fetch_add(1, std::memory_order_relaxed) %
+                this->workers.size();
+    }
+
+    Worker &worker{*this->workers[index]};
+    {
+        std::lock_guard<std::mutex> lock{worker.mutex};
+        worker.queues[static_cast<int>(priority)].push_back(std::move(task));
+    }
+
+    this->queued.fetch_add(1, std::memory_order_release);
+
+    {
+        // Pairs with the predicate check in workerLoop so a worker about to
+        // sleep can't miss this job
+        std::lock_guard<std::mutex> lock{this->sleepMutex};
+    }
+    this->wakeUp.notify_one();
+}
+
+bool JobSystem::runOne(int self) {
+    int workerCount{static_cast<int>(this->workers.size())};
+
+    for (int priority = 0; priority < PRIORITY_COUNT; priority++) {
+        for (int offset = 0; offset < workerCount; offset++) {
+            int victim{((self < 0 ? 0 : self) + offset) % workerCount};
+            bool own{victim == self};
+
+            Worker &worker{*this->workers[victim]};
+            Task task;
+
+            {
+                std::lock_guard<std::mutex> lock{worker.mutex};
+                auto &queue{worker.queues[priority]};
+                if (queue.empty()) {
+                    continue;
+                }
+
+                // Newest first on our own deque (cache warm), oldest first
+                // when stealing
+                if (own) {
+                    task = std::move(queue.back());
+                    queue.pop_back();
+                } else {
+                    task = std::move(queue.front());
+                    queue.pop_front();
+                }
+            }
+
+            this->queued.fetch_sub(1, std::memory_order_relaxed);
+
+            task.job();
+            task.pending->fetch_sub(1, std::memory_order_release);
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::workerLoop(int self) {
+    currentSystem = this;
+    currentWorker = self;
+
+    utils::Profiler::get().setThreadName("Worker " + std::to_string(self));
+
+    while (true) {
+        if (this->runOne(self)) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock{this->sleepMutex};
+        this->wakeUp.wait(lock, [this]() {
+            return !this->running ||
+                   this->queued.load(std::memory_order_acquire) > 0;
+        });
+
+        if (!this->running && this->queued.load() == 0) {
+            break;
+        }
+    }
+
+    currentSystem = nullptr;
+    currentWorker = -1;
+}
+
+} // namespace jobs
+
+} // namespace mine
@@ -1,14 +1,27 @@
+#include "Benchmark.hpp"
 #include "Camera.hpp"
+#include "Flythrough.hpp"
 #include "Program.hpp"
 #include "glm/ext/matrix_clip_space.hpp"
+#include "jobs/JobSystem.hpp"
 #include "opengl/GLBuffer.hpp"
+#include "opengl/GLState.hpp"
+#include "opengl/GpuProfiler.hpp"
+#include "opengl/ShaderLibrary.hpp"
 #include "opengl/ShaderProgram.hpp"
 #include "opengl/VertexArray.hpp"
 #include "opengl/Window.hpp"
 #include "opengl/gl_includes.hpp"
+#include "utils/Profiler.hpp"
+#include "render/BlockTextures.hpp"
+#include "render/ChunkRenderer.hpp"
+#include "render/FrameUniforms.hpp"
+#include "world/TerrainGenerator.hpp"
+#include "world/World.hpp"
 
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstdlib>
 #include <fstream>
 #include <functional>
@@ -26,13 +39,95 @@
 
 inline void clearScreen() {
     glClearColor(0.2f, 0.3f, 0.9f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
 float x_pos = 0.0f;
 float look_at_x = 0.0f;
 
-void events(mine::Program &program, mine::Camera &camera) {
+constexpr const char *CHUNK_VERTEX_SHADER{"shaders/vertex.glsl"};
+constexpr const char *CHUNK_FRAGMENT_SHADER{"shaders/fragment.glsl"};
+
+/**
+ * Command line flags
+ */
+struct Options {
+    bool headless{false};
+
+    // Stop after this many frames, 0 runs until the window is closed
+    long frames{0};
+
+    // Where the benchmark report goes, null when not benchmarking
+    const char *benchmark{nullptr};
+
+    // Recorded flythrough, the scripted one is used without it
+    const char *path{nullptr};
+
+    std::uint32_t seed{0};
+
+    // Where the profiler's trace goes, null keeps the profiler off
+    const char *trace{nullptr};
+};
+
+/**
+ * Optional chunk shading, each combination is compiled as its own program
+ * so disabled features cost nothing per pixel
+ */
+struct ShaderFeatures {
+    bool ambientOcclusion{true};
+    bool fog{true};
+
+    mine::opengl::ShaderDefines defines() const {
+        mine::opengl::ShaderDefines defines;
+
+        if (this->ambientOcclusion) {
+            defines.push_back("AMBIENT_OCCLUSION");
+        }
+
+        if (this->fog) {
+            defines.push_back("FOG");
+        }
+
+        return defines;
+    }
+};
+
+/**
+ * The chunk program for the current features, looked up in the library
+ * only after they change rather than every frame
+ */
+struct ChunkShader {
+    ShaderFeatures features;
+    mine::opengl::ShaderProgram *program{nullptr};
+
+    mine::opengl::ShaderProgram &get(mine::opengl::ShaderLibrary &shaders) {
+        if (!this->program) {
+            this->program = &shaders.get(CHUNK_VERTEX_SHADER,
+                                         CHUNK_FRAGMENT_SHADER,
+                                         this->features.defines());
+        }
+
+        return *this->program;
+    }
+};
+
+/**
+ * Poll the window and stop on close, without any of the key toggles
+ */
+void windowEvents(mine::Program &program) {
+    mine::opengl::Window &window = program.getWindow();
+    window.pollEvents();
+
+    if (window.isKeyPressed(GLFW_KEY_ESCAPE) || window.shouldClose()) {
+        program.stop();
+    }
+}
+
+void events(mine::Program &program, mine::Camera &camera,
+            mine::render::ChunkRenderer &renderer, ChunkShader &chunkShader,
+            const Options &options) {
+    mine::utils::ProfileZone zone{"events"};
+
     static std::map<int, mine::Camera::Direction> keyToDirection{
         {GLFW_KEY_W, mine::Camera::Direction::FORWARD},
         {GLFW_KEY_S, mine::Camera::Direction::BACKWARD},
@@ -44,12 +139,9 @@ void events(mine::Program &program, mine::Camera &camera) {
         {GLFW_KEY_X, mine::Camera::Direction::DOWN},
     };
 
-    mine::opengl::Window &window = program.getWindow();
-    window.pollEvents();
+    windowEvents(program);
 
-    if (window.isKeyPressed(GLFW_KEY_ESCAPE) || window.shouldClose()) {
-        program.stop();
-    }
+    mine::opengl::Window &window = program.getWindow();
 
     for (auto [key, direction] : keyToDirection) {
         if (window.isKeyPressed(key)) {
@@ -57,16 +149,117 @@ void events(mine::Program &program, mine::Camera &camera) {
         }
     }
 
+    // Cycle through meshing algorithms on key release
+    static bool wasMeshingKeyPressed{false};
+    bool meshingKeyPressed{window.isKeyPressed(GLFW_KEY_G)};
+
+    if (wasMeshingKeyPressed && !meshingKeyPressed) {
+        using mine::render::MeshingMode;
+
+        switch (renderer.getMeshingMode()) {
+        case MeshingMode::CULLED:
+            renderer.setMeshingMode(MeshingMode::GREEDY);
+            break;
+
+        case MeshingMode::GREEDY:
+            renderer.setMeshingMode(MeshingMode::BINARY);
+            break;
+
+        case MeshingMode::BINARY:
+            renderer.setMeshingMode(MeshingMode::CULLED);
+            break;
+        }
+    }
+
+    wasMeshingKeyPressed = meshingKeyPressed;
+
+    // Toggle visibility culling on key release
+    static bool wasCullingKeyPressed{false};
+    bool cullingKeyPressed{window.isKeyPressed(GLFW_KEY_V)};
+
+    if (wasCullingKeyPressed && !cullingKeyPressed) {
+        renderer.setVisibilityCulling(!renderer.getVisibilityCulling());
+    }
+
+    wasCullingKeyPressed = cullingKeyPressed;
+
+    // Cycle through occlusion culling modes on key release
+    static bool wasOcclusionKeyPressed{false};
+    bool occlusionKeyPressed{window.isKeyPressed(GLFW_KEY_O)};
+
+    if (wasOcclusionKeyPressed && !occlusionKeyPressed) {
+        using mine::render::OcclusionMode;
+
+        switch (renderer.getOcclusionMode()) {
+        case OcclusionMode::NONE:
+            renderer.setOcclusionMode(OcclusionMode::SOFTWARE);
+            break;
+
+        case OcclusionMode::SOFTWARE:
+            renderer.setOcclusionMode(OcclusionMode::HARDWARE);
+            break;
+
+        case OcclusionMode::HARDWARE:
+            renderer.setOcclusionMode(OcclusionMode::NONE);
+            break;
+        }
+    }
+
+    wasOcclusionKeyPressed = occlusionKeyPressed;
+
+    // Toggle shader features on key release
+    static bool wasFogKeyPressed{false};
+    bool fogKeyPressed{window.isKeyPressed(GLFW_KEY_F)};
+
+    if (wasFogKeyPressed && !fogKeyPressed) {
+        chunkShader.features.fog = !chunkShader.features.fog;
+        chunkShader.program = nullptr;
+    }
+
+    wasFogKeyPressed = fogKeyPressed;
+
+    static bool wasAmbientOcclusionKeyPressed{false};
+    bool ambientOcclusionKeyPressed{window.isKeyPressed(GLFW_KEY_B)};
+
+    if (wasAmbientOcclusionKeyPressed && !ambientOcclusionKeyPressed) {
+        chunkShader.features.ambientOcclusion =
+            !chunkShader.features.ambientOcclusion;
+        chunkShader.program = nullptr;
+    }
+
+    wasAmbientOcclusionKeyPressed = ambientOcclusionKeyPressed;
+
+    // Write the profiler's trace so far on key release
+    static bool wasTraceKeyPressed{false};
+    bool traceKeyPressed{window.isKeyPressed(GLFW_KEY_T)};
+
+    if (wasTraceKeyPressed && !traceKeyPressed && options.trace) {
+        mine::utils::Profiler::get().writeChromeTrace(options.trace);
+    }
+
+    wasTraceKeyPressed = traceKeyPressed;
+
     camera.handleMouseMovement(window.getCursorPos());
 }
 
-void render(mine::Program &program, mine::opengl::VertexArray &vao,
-            mine::opengl::ShaderProgram &shaderProgram, mine::Camera &camera) {
-    clearScreen();
+void render(mine::Program &program, mine::render::ChunkRenderer &renderer,
+            mine::render::FrameUniforms &frameUniforms,
+            mine::render::BlockTextures &blockTextures,
+            mine::opengl::ShaderLibrary &shaders,
+            ChunkShader &chunkShader, mine::Camera &camera,
+            mine::opengl::GpuProfiler &gpuProfiler) {
+    mine::utils::ProfileZone zone{"render"};
 
-    shaderProgram.use();
+    gpuProfiler.beginFrame();
 
-    vao.bind();
+    {
+        mine::opengl::GpuZone gpuZone{gpuProfiler, "clear"};
+        clearScreen();
+    }
+
+    mine::opengl::ShaderProgram &shaderProgram{chunkShader.get(shaders)};
+
+    shaderProgram.use();
 
     const mine::opengl::Window &window{program.getWindow()};
 
@@ -74,30 +267,119 @@ void render(mine::Program &program, mine::opengl::VertexArray &vao,
     float height{static_cast<float>(window.getHeight())};
 
     float near{0.1};
-    float far{100.0};
+    float far{500.0};
 
     glm::mat4 projection{
         glm::perspective(glm::radians(45.0f), width / height, near, far)};
 
     glm::mat4 view{camera.calculateLookAtMatrix()};
-    glm::mat4 model{glm::mat4(1.0f)};
 
-    glm::mat4 mvp{projection * view * model};
+    mine::render::FrameData frame{};
+    frame.viewProjection = projection * view;
+    frame.view = view;
+    frame.projection = projection;
+    frame.cameraPosition = glm::vec4{camera.getPosition(), 1.0f};
+    frame.parameters = glm::vec4{static_cast<float>(glfwGetTime()), near, far,
+                                 0.0f};
 
-    shaderProgram.uniform<3>("offset", glm::vec3{-0.0f, 0.5f, 0.2f});
-    shaderProgram.uniform<4>("color", glm::vec4{1.0f, 0.5f, 0.2f, 1.0f});
-    shaderProgram.uniform<4>("mvp", mvp);
+    frameUniforms.update(frame);
 
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    blockTextures.bind();
+    shaderProgram.uniform<1>(
+        "blockTextures", glm::vec<1, int>{mine::render::BlockTextures::UNIT});
 
-    shaderProgram.unuse();
+    {
+        mine::opengl::GpuZone gpuZone{gpuProfiler, "chunks"};
+        renderer.draw(shaderProgram, frame.viewProjection,
+                      camera.getPosition());
+    }
 
-    vao.unbind();
+    shaderProgram.unuse();
+}
 
+void present(mine::Program &program) {
+    mine::utils::ProfileZone zone{"present"};
     program.getWindow().swapBuffers();
 }
 
-void init() {
+Options parseOptions(int argc, char **argv) {
+    Options options;
+
+    for (int i = 1; i < argc; i++) {
+        std::string argument{argv[i]};
+
+        if (argument == "--headless") {
+            options.headless = true;
+        } else if (argument == "--frames" && i + 1 < argc) {
+            options.frames = std::strtol(argv[++i], nullptr, 10);
+        } else if (argument == "--benchmark" && i + 1 < argc) {
+            options.benchmark = argv[++i];
+        } else if (argument == "--path" && i + 1 < argc) {
+            options.path = argv[++i];
+        } else if (argument == "--trace" && i + 1 < argc) {
+            options.trace = argv[++i];
+        } else if (argument == "--seed" && i + 1 < argc) {
+            options.seed = static_cast<std::uint32_t>(
+                std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--headless] [--frames <count>]"
+                         " [--benchmark <report.json> [--path <keyframes>]]"
+                         " [--seed <seed>] [--trace <trace.json>]"
+                      << std::endl;
+            exit(1);
+        }
+    }
+
+    // A benchmark always ends
+    if (options.benchmark && options.frames <= 0) {
+        options.frames = 1000;
+    }
+
+    return options;
+}
+
+/**
+ * A loop around the middle of the generated world, skimming the terrain and
+ * looking ahead along the path
+ */
+mine::Flythrough
+scriptedFlythrough(const mine::world::TerrainGenerator &generator) {
+    constexpr int KEYFRAMES{17};
+    constexpr float RADIUS{80.0f};
+    constexpr float ALTITUDE{12.0f};
+
+    auto pointAt{[&generator](int i) {
+        float angle{glm::two_pi<float>() * static_cast<float>(i) /
+                    static_cast<float>(KEYFRAMES - 1)};
+        float x{std::cos(angle) * RADIUS};
+        float z{std::sin(angle) * RADIUS};
+
+        float ground{static_cast<float>(generator.heightAt(
+            static_cast<int>(x), static_cast<int>(z)))};
+
+        return glm::vec3{x, ground + ALTITUDE, z};
+    }};
+
+    std::vector<mine::Flythrough::Keyframe> keyframes;
+    for (int i = 0; i < KEYFRAMES; i++) {
+        glm::vec3 ahead{pointAt(i + 1)};
+        keyframes.push_back({pointAt(i), ahead - glm::vec3{0.0f, 4.0f, 0.0f}});
+    }
+
+    return mine::Flythrough{std::move(keyframes)};
+}
+
+double milliseconds(std::chrono::steady_clock::time_point from,
+                    std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+void init(const Options &options) {
+    if (options.headless) {
+        mine::opengl::preferHeadlessPlatform();
+    }
+
     atexit([]() { glfwTerminate(); });
     if (!glfwInit()) {
         std::cerr << "Failed to initialize GLFW" << std::endl;
@@ -105,43 +387,159 @@ void init() {
     }
 }
 
-int main() {
-    init();
+int main(int argc, char **argv) {
+    Options options{parseOptions(argc, argv)};
+    init(options);
 
-    mine::Program program;
+    mine::utils::Profiler &profiler{mine::utils::Profiler::get()};
+    profiler.setEnabled(options.trace != nullptr);
+    profiler.setThreadName("Main");
 
-    auto shaderProgram{mine::opengl::ShaderProgram::fromFiles(
-        "shaders/vertex.glsl", "shaders/fragment.glsl")};
+    mine::Program program{"Hello, World!", 640, 480,
+                          options.headless
+                              ? mine::opengl::WindowMode::HEADLESS
+                              : mine::opengl::WindowMode::VISIBLE};
 
-    mine::opengl::VertexArray vao{[](mine::opengl::VertexArray &vao) {
-        // Square vertices
-        float vertices[] = {
-            0.5f,  0.5f,  0.0f, // top right
-            0.5f,  -0.5f, 0.0f, // bottom right
-            -0.5f, -0.5f, 0.0f, // bottom left
-            -0.5f, 0.5f,  0.0f  // top left
-        };
+    mine::opengl::ShaderProgram::setBinaryCacheDirectory("shader_cache");
 
-        unsigned int indices[] = {
-            0, 1, 3, // first Triangle
-            1, 2, 3  // second Triangle
-        };
+    mine::opengl::GpuProfiler gpuProfiler;
 
-        auto &vbo{vao.addBuffer()};
-        auto &ebo{vao.addBuffer(GL_ELEMENT_ARRAY_BUFFER)};
+    mine::render::FrameUniforms frameUniforms;
 
-        vbo.bufferData(sizeof(vertices), vertices, GL_STATIC_DRAW);
-        ebo.bufferData(sizeof(indices), indices, GL_STATIC_DRAW);
+    mine::opengl::ShaderLibrary shaders{
+        [&frameUniforms](mine::opengl::ShaderProgram &shaderProgram) {
+            frameUniforms.attach(shaderProgram);
+        }};
 
-        vao.vertexAttribPointer(0, 3, GL_FLOAT, false, 3 * sizeof(float), 0);
-    }};
+    // Compiled by the driver while the world generates, checked on first use
+    ChunkShader chunkShader;
+    shaders.prepare(CHUNK_VERTEX_SHADER, CHUNK_FRAGMENT_SHADER,
+                    chunkShader.features.defines());
+
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_CULL_FACE);
+
+    mine::jobs::JobSystem jobSystem;
+
+    mine::world::World world;
+    mine::world::TerrainGenerator generator{options.seed};
+    generator.generate(world, {-8, -1, -8}, {8, 3, 8}, jobSystem);
+
+    mine::render::BlockTextures blockTextures{"textures", "textures.cache",
+                                             jobSystem};
+
+    mine::render::ChunkRenderer renderer{jobSystem};
 
     mine::Camera camera{0.3f, 0.01f};
-    camera.setPosition({0.0f, 0.0f, -1.0f});
+    camera.setPosition({0.0f, 40.0f, -1.0f});
+
+    auto frame{[&]() {
+        events(program, camera, renderer, chunkShader, options);
+        renderer.update(world);
+        render(program, renderer, frameUniforms, blockTextures, shaders,
+               chunkShader, camera, gpuProfiler);
+        present(program);
+    }};
+
+    if (!options.benchmark) {
+        for (long i = 1; program.isRunning(); i++) {
+            frame();
+
+            if (i == options.frames) {
+                program.stop();
+            }
+        }
+    } else {
+        using Clock = std::chrono::steady_clock;
+
+        mine::Flythrough flythrough{
+            options.path ? mine::Flythrough::fromFile(options.path)
+                         : scriptedFlythrough(generator)};
+
+        mine::Benchmark benchmark;
+        benchmark.setInfo("seed", options.seed);
+        benchmark.setInfo("frames", static_cast<double>(options.frames));
+        benchmark.setInfo("path", options.path ? options.path : "scripted");
+        benchmark.setInfo("headless", options.headless ? "yes" : "no");
+        benchmark.setInfo("renderer", reinterpret_cast<const char *>(
+                                          glGetString(GL_RENDERER)));
+
+        // Mesh the whole world first, the run then measures steady state
+        // rendering rather than how fast the job system catches up
+        Clock::time_point warmupStart{Clock::now()};
+        long warmupFrames{0};
+
+        // Only the window is polled, toggles and mouse look would change
+        // what's being measured mid-run
+        do {
+            windowEvents(program);
+            flythrough.apply(camera, 0.0f);
+            renderer.update(world);
+            render(program, renderer, frameUniforms, blockTextures, shaders,
+                   chunkShader, camera, gpuProfiler);
+            present(program);
+            warmupFrames++;
+        } while (renderer.getPendingCount() > 0 && program.isRunning());
+
+        benchmark.setInfo("warmupFrames", static_cast<double>(warmupFrames));
+        benchmark.setInfo("warmupMs", milliseconds(warmupStart, Clock::now()));
+
+        // Bind counts cover the measured frames only
+        mine::opengl::GLState::get().resetStats();
+
+        std::size_t frameMs{benchmark.addSeries("frameMs")};
+        std::size_t eventsMs{benchmark.addSeries("eventsMs")};
+        std::size_t updateMs{benchmark.addSeries("updateMs")};
+        std::size_t renderMs{benchmark.addSeries("renderMs")};
+        std::size_t presentMs{benchmark.addSeries("presentMs")};
+        std::size_t visibleChunks{benchmark.addSeries("visibleChunks")};
+        benchmark.reserve(static_cast<std::size_t>(options.frames));
+
+        float lastFrame{static_cast<float>(std::max(options.frames - 1, 1L))};
+
+        for (long i = 0; i < options.frames && program.isRunning(); i++) {
+            Clock::time_point start{Clock::now()};
+            windowEvents(program);
+
+            // Driven by the frame number, not by time, so every run renders
+            // the same views
+            flythrough.apply(camera, static_cast<float>(i) / lastFrame);
+
+            Clock::time_point updateStart{Clock::now()};
+            renderer.update(world);
+
+            Clock::time_point renderStart{Clock::now()};
+            render(program, renderer, frameUniforms, blockTextures, shaders,
+                   chunkShader, camera, gpuProfiler);
+
+            Clock::time_point presentStart{Clock::now()};
+            present(program);
+
+            Clock::time_point end{Clock::now()};
+
+            benchmark.record(frameMs, milliseconds(start, end));
+            benchmark.record(eventsMs, milliseconds(start, updateStart));
+            benchmark.record(updateMs, milliseconds(updateStart, renderStart));
+            benchmark.record(renderMs, milliseconds(renderStart, presentStart));
+            benchmark.record(presentMs, milliseconds(presentStart, end));
+            benchmark.record(visibleChunks,
+                             static_cast<double>(renderer.getVisibleCount()));
+        }
+
+        const auto &glStats{mine::opengl::GLState::get().getStats()};
+        benchmark.setInfo("glBindsIssued", static_cast<double>(glStats.issued));
+        benchmark.setInfo("glBindsSkipped",
+                          static_cast<double>(glStats.skipped));
+
+        if (!benchmark.writeJson(options.benchmark)) {
+            std::cerr << "Failed to write benchmark report: "
+                      << options.benchmark << std::endl;
+            return 1;
+        }
+    }
 
-    while (program.isRunning()) {
-        events(program, camera);
-        render(program, vao, shaderProgram, camera);
+    if (options.trace && !profiler.writeChromeTrace(options.trace)) {
+        std::cerr << "Failed to write trace: " << options.trace << std::endl;
     }
 
     return 0;
@@ -0,0 +1,86 @@
+#include "opengl/Extensions.hpp"
+
+#include <cstring>
+
+namespace mine {
+
+namespace opengl {
+
+namespace {
+
+Extensions extensions;
+
+} // namespace
+
+bool Extensions::hasVersion(int major, int minor) const {
+    return this->majorVersion > major ||
+           (this->majorVersion == major && this->minorVersion >= minor);
+}
+
+void loadExtensions(GLADloadproc load) {
+    extensions = {};
+
+    glGetIntegerv(GL_MAJOR_VERSION, &extensions.majorVersion);
+    glGetIntegerv(GL_MINOR_VERSION, &extensions.minorVersion);
+
+    if (extensions.hasVersion(4, 3) ||
+        hasExtension("GL_ARB_multi_draw_indirect")) {
+        extensions.multiDrawElementsIndirect =
+            reinterpret_cast<MultiDrawElementsIndirectProc>(
+                load("glMultiDrawElementsIndirect"));
+    }
+
+    if (extensions.hasVersion(4, 1) ||
+        hasExtension("GL_ARB_get_program_binary")) {
+        GLint formats{0};
+        glGetIntegerv(NUM_PROGRAM_BINARY_FORMATS, &formats);
+
+        if (formats > 0) {
+            extensions.getProgramBinary =
+                reinterpret_cast<GetProgramBinaryProc>(
+                    load("glGetProgramBinary"));
+            extensions.programBinary =
+                reinterpret_cast<ProgramBinaryProc>(load("glProgramBinary"));
+            extensions.programParameteri =
+                reinterpret_cast<ProgramParameteriProc>(
+                    load("glProgramParameteri"));
+        }
+    }
+
+    if (hasExtension("GL_KHR_parallel_shader_compile")) {
+        extensions.maxShaderCompilerThreads =
+            reinterpret_cast<MaxShaderCompilerThreadsProc>(
+                load("glMaxShaderCompilerThreadsKHR"));
+    } else if (hasExtension("GL_ARB_parallel_shader_compile")) {
+        extensions.maxShaderCompilerThreads =
+            reinterpret_cast<MaxShaderCompilerThreadsProc>(
+                load("glMaxShaderCompilerThreadsARB"));
+    }
+
+    // Let the driver pick how many threads to use
+    if (extensions.maxShaderCompilerThreads) {
+        extensions.maxShaderCompilerThreads(0xFFFFFFFFu);
+    }
+}
+
+const Extensions &getExtensions() { return extensions; }
+
+bool hasExtension(const char *name) {
+    GLint count{0};
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+    for (GLint i = 0; i < count; i++) {
+        const char *extension{reinterpret_cast<const char *>(
+            glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)))};
+
+        if (extension && std::strcmp(extension, name) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace opengl
+
+} // namespace mine
@@ -1,4 +1,5 @@
 #include "opengl/GLBuffer.hpp"
+#include "opengl/GLState.hpp"
 
 #include <cassert>
 #include <iostream>
@@ -22,6 +23,7 @@ GLBuffer::GLBuffer(GLBuffer &&other) noexcept
 
 void GLBuffer::operator=(GLBuffer &&other) noexcept {
     if (this->id) {
+        GLState::get().forgetBuffer(this->id);
         glDeleteBuffers(1, &this->id);
     }
 
@@ -33,6 +35,7 @@ void GLBuffer::operator=(GLBuffer &&other) noexcept {
 
 GLBuffer::~GLBuffer() {
     if (this->id) {
+        GLState::get().forgetBuffer(this->id);
         glDeleteBuffers(1, &this->id);
     }
 }
@@ -40,24 +43,38 @@ GLBuffer::~GLBuffer() {
 void GLBuffer::bind() {
     assert(this->id);
     this->isBound = true;
-    glBindBuffer(this->target, this->id);
+    GLState::get().bindBuffer(this->target, this->id);
 }
 
 void GLBuffer::unbind() {
     assert(this->id);
     this->isBound = false;
-    glBindBuffer(this->target, 0);
+    GLState::get().bindBuffer(this->target, 0);
 }
 
 void GLBuffer::bufferData(GLsizeiptr size, const void *data, GLenum usage) {
     assert(this->id);
-    if (!this->isBound) {
-        this->bind();
-    }
+
+    // Always rebind, another buffer may have taken the target since, the
+    // state cache makes this free when it hasn't
+    this->bind();
 
     glBufferData(this->target, size, data, usage);
 }
 
+void GLBuffer::bufferSubData(GLintptr offset, GLsizeiptr size,
+                             const void *data) {
+    assert(this->id);
+    this->bind();
+
+    glBufferSubData(this->target, offset, size, data);
+}
+
+void GLBuffer::bindBase(GLuint index) {
+    assert(this->id);
+    GLState::get().bindBufferBase(this->target, index, this->id);
+}
+
 unsigned int GLBuffer::get() {
     assert(this->id);
     return this->id;
@@ -0,0 +1,220 @@
+#include "opengl/GLState.hpp"
+#include "opengl/Extensions.hpp"
+
+namespace mine {
+
+namespace opengl {
+
+GLState &GLState::get() {
+    static GLState state;
+    return state;
+}
+
+GLState::GLState() { this->invalidate(); }
+
+void GLState::useProgram(GLuint program) {
+    if (this->update(this->program, program)) {
+        glUseProgram(program);
+    }
+}
+
+void GLState::bindVertexArray(GLuint vertexArray) {
+    if (this->update(this->vertexArray, vertexArray)) {
+        glBindVertexArray(vertexArray);
+    }
+}
+
+void GLState::bindBuffer(GLenum target, GLuint buffer) {
+    if (target == GL_ELEMENT_ARRAY_BUFFER) {
+        // Unknown vertex array, or one bound behind our back
+        if (this->vertexArray == UNKNOWN) {
+            this->stats.issued++;
+            glBindBuffer(target, buffer);
+            return;
+        }
+
+        auto it{this->elementBuffers.find(this->vertexArray)};
+        GLuint current{it == this->elementBuffers.end() ? 0 : it->second};
+
+        if (this->update(current, buffer)) {
+            this->elementBuffers[this->vertexArray] = buffer;
+            glBindBuffer(target, buffer);
+        }
+
+        return;
+    }
+
+    int slot{bufferSlot(target)};
+    if (slot < 0) {
+        this->stats.issued++;
+        glBindBuffer(target, buffer);
+        return;
+    }
+
+    if (this->update(this->buffers[slot], buffer)) {
+        glBindBuffer(target, buffer);
+    }
+}
+
+void GLState::bindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+    // Binding an indexed target also binds the generic one
+    int slot{bufferSlot(target)};
+    bool genericBound{slot >= 0 && this->buffers[slot] == buffer};
+    if (slot >= 0) {
+        this->buffers[slot] = buffer;
+    }
+
+    if (target != GL_UNIFORM_BUFFER || index >= UNIFORM_BINDINGS) {
+        this->stats.issued++;
+        glBindBufferBase(target, index, buffer);
+        return;
+    }
+
+    if (this->update(this->uniformBindings[index], buffer)) {
+        glBindBufferBase(target, index, buffer);
+    } else if (!genericBound) {
+        this->stats.issued++;
+        glBindBuffer(target, buffer);
+    }
+}
+
+void GLState::activeTexture(GLuint unit) {
+    if (this->update(this->activeUnit, unit)) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+    }
+}
+
+void GLState::bindTexture(GLuint unit, GLenum target, GLuint texture) {
+    int slot{textureSlot(target)};
+    if (slot < 0 || unit >= TEXTURE_UNITS) {
+        this->activeTexture(unit);
+        this->stats.issued++;
+        glBindTexture(target, texture);
+        return;
+    }
+
+    if (this->textures[unit][slot] == texture) {
+        this->stats.skipped++;
+        return;
+    }
+
+    this->activeTexture(unit);
+    this->update(this->textures[unit][slot], texture);
+    glBindTexture(target, texture);
+}
+
+void GLState::forgetProgram(GLuint program) {
+    if (this->program == program) {
+        this->program = UNKNOWN;
+    }
+}
+
+void GLState::forgetVertexArray(GLuint vertexArray) {
+    if (this->vertexArray == vertexArray) {
+        this->vertexArray = UNKNOWN;
+    }
+
+    this->elementBuffers.erase(vertexArray);
+}
+
+void GLState::forgetBuffer(GLuint buffer) {
+    for (auto &bound : this->buffers) {
+        if (bound == buffer) {
+            bound = 0;
+        }
+    }
+
+    for (auto &bound : this->uniformBindings) {
+        if (bound == buffer) {
+            bound = 0;
+        }
+    }
+
+    for (auto &[vertexArray, bound] : this->elementBuffers) {
+        if (bound == buffer) {
+            bound = 0;
+        }
+    }
+}
+
+void GLState::forgetTexture(GLuint texture) {
+    for (auto &unit : this->textures) {
+        for (auto &bound : unit) {
+            if (bound == texture) {
+                bound = 0;
+            }
+        }
+    }
+}
+
+void GLState::invalidate() {
+    this->program = UNKNOWN;
+    this->vertexArray = UNKNOWN;
+    this->activeUnit = UNKNOWN;
+
+    this->buffers.fill(UNKNOWN);
+    this->uniformBindings.fill(UNKNOWN);
+    for (auto &unit : this->textures) {
+        unit.fill(UNKNOWN);
+    }
+
+    this->elementBuffers.clear();
+}
+
+const GLState::Stats &GLState::getStats() const { return this->stats; }
+
+void GLState::resetStats() { this->stats = {}; }
+
+bool GLState::update(GLuint &cached, GLuint value) {
+    if (cached == value) {
+        this->stats.skipped++;
+        return false;
+    }
+
+    cached = value;
+    this->stats.issued++;
+
+    return true;
+}
+
+int GLState::bufferSlot(GLenum target) {
+    switch (target) {
+    case GL_ARRAY_BUFFER:
+        return 0;
+    case GL_UNIFORM_BUFFER:
+        return 1;
+    case GL_COPY_READ_BUFFER:
+        return 2;
+    case GL_COPY_WRITE_BUFFER:
+        return 3;
+    case GL_PIXEL_PACK_BUFFER:
+        return 4;
+    case GL_PIXEL_UNPACK_BUFFER:
+        return 5;
+    case GL_TEXTURE_BUFFER:
+        return 6;
+    case DRAW_INDIRECT_BUFFER:
+        return 7;
+    default:
+        return -1;
+    }
+}
+
+int GLState::textureSlot(GLenum target) {
+    switch (target) {
+    case GL_TEXTURE_2D:
+        return 0;
+    case GL_TEXTURE_2D_ARRAY:
+        return 1;
+    case GL_TEXTURE_3D:
+        return 2;
+    case GL_TEXTURE_BUFFER:
+        return 3;
+    default:
+        return -1;
+    }
+}
+
+} // namespace opengl
+
+} // namespace mine
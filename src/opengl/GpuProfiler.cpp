@@ -0,0 +1,138 @@
+#include "opengl/GpuProfiler.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace mine {
+
+namespace opengl {
+
+GpuProfiler::GpuProfiler() {
+    if (!glad_glQueryCounter || !glad_glGetQueryObjectui64v ||
+        !glad_glGetInteger64v) {
+        return;
+    }
+
+    // Zero bits means the driver has the entry points but no timer
+    GLint bits{0};
+    glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &bits);
+
+    this->supported = bits > 0;
+}
+
+GpuProfiler::~GpuProfiler() {
+    for (Frame &frame : this->frames) {
+        if (!frame.queries.empty()) {
+            glDeleteQueries(static_cast<GLsizei>(frame.queries.size()),
+                            frame.queries.data());
+        }
+    }
+}
+
+bool GpuProfiler::isSupported() const { return this->supported; }
+
+void GpuProfiler::beginFrame() {
+    if (!this->supported) {
+        return;
+    }
+
+    assert(this->open.empty());
+
+    // The slot about to be reused holds the oldest frame still in flight
+    this->current = (this->current + 1) % FRAMES_IN_FLIGHT;
+    Frame &frame{this->frames[this->current]};
+
+    this->collect(frame);
+
+    utils::Profiler &profiler{utils::Profiler::get()};
+    frame.recording = profiler.isEnabled();
+
+    if (frame.recording) {
+        GLint64 gpuNow{0};
+        glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+
+        frame.clockOffset = static_cast<std::int64_t>(profiler.now()) -
+                            static_cast<std::int64_t>(gpuNow);
+    }
+}
+
+void GpuProfiler::beginPass(const char *name) {
+    Frame &frame{this->frames[this->current]};
+    if (!this->supported || !frame.recording) {
+        return;
+    }
+
+    this->open.push_back(frame.passes.size());
+    frame.passes.push_back({name, this->timestamp(frame), 0});
+}
+
+void GpuProfiler::endPass() {
+    Frame &frame{this->frames[this->current]};
+    if (!this->supported || !frame.recording) {
+        return;
+    }
+
+    assert(!this->open.empty());
+
+    frame.passes[this->open.back()].end = this->timestamp(frame);
+    this->open.pop_back();
+}
+
+std::size_t GpuProfiler::timestamp(Frame &frame) {
+    if (frame.used == frame.queries.size()) {
+        GLuint query{0};
+        glGenQueries(1, &query);
+        frame.queries.push_back(query);
+    }
+
+    glQueryCounter(frame.queries[frame.used], GL_TIMESTAMP);
+    return frame.used++;
+}
+
+void GpuProfiler::collect(Frame &frame) {
+    if (frame.used > 0) {
+        // The GPU finishes commands in order, the last timestamp being
+        // there means all of them are
+        GLint available{0};
+        glGetQueryObjectiv(frame.queries[frame.used - 1],
+                           GL_QUERY_RESULT_AVAILABLE, &available);
+
+        if (available) {
+            utils::Profiler &profiler{utils::Profiler::get()};
+            if (!this->track) {
+                this->track = &profiler.addTrack("GPU");
+            }
+
+            auto toProfilerClock{[&frame](GLuint64 time) {
+                return static_cast<std::uint64_t>(std::max<std::int64_t>(
+                    static_cast<std::int64_t>(time) + frame.clockOffset, 0));
+            }};
+
+            for (const Pass &pass : frame.passes) {
+                GLuint64 begin{0};
+                GLuint64 end{0};
+                glGetQueryObjectui64v(frame.queries[pass.begin],
+                                      GL_QUERY_RESULT, &begin);
+                glGetQueryObjectui64v(frame.queries[pass.end],
+                                      GL_QUERY_RESULT, &end);
+
+                profiler.record(*this->track, pass.name,
+                                toProfilerClock(begin), toProfilerClock(end));
+            }
+        }
+    }
+
+    frame.passes.clear();
+    frame.used = 0;
+}
+
+GpuZone::GpuZone(GpuProfiler &profiler, const char *name)
+    : profiler{profiler} {
+    this->profiler.beginPass(name);
+}
+
+GpuZone::~GpuZone() { this->profiler.endPass(); }
+
+} // namespace opengl
+
+} // namespace mine
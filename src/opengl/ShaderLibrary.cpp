@@ -0,0 +1,55 @@
+#include "opengl/ShaderLibrary.hpp"
+
+namespace mine {
+
+namespace opengl {
+
+ShaderLibrary::ShaderLibrary(Setup setup) : setup{std::move(setup)} {}
+
+void ShaderLibrary::prepare(const char *vertexShaderPath,
+                            const char *fragmentShaderPath,
+                            const ShaderDefines &defines) {
+    this->find(vertexShaderPath, fragmentShaderPath, defines);
+}
+
+ShaderProgram &ShaderLibrary::get(const char *vertexShaderPath,
+                                  const char *fragmentShaderPath,
+                                  const ShaderDefines &defines) {
+    Entry &entry{this->find(vertexShaderPath, fragmentShaderPath, defines)};
+
+    if (!entry.ready) {
+        if (this->setup) {
+            this->setup(*entry.program);
+        }
+
+        entry.ready = true;
+    }
+
+    return *entry.program;
+}
+
+std::size_t ShaderLibrary::size() const { return this->programs.size(); }
+
+ShaderLibrary::Entry &ShaderLibrary::find(const char *vertexShaderPath,
+                                          const char *fragmentShaderPath,
+                                          const ShaderDefines &defines) {
+    std::string key{std::string{vertexShaderPath} + "\n" +
+                    fragmentShaderPath + "\n" + definesKey(defines)};
+
+    auto it{this->programs.find(key)};
+    if (it != this->programs.end()) {
+        return it->second;
+    }
+
+    // Compiled deferred so prepared permutations overlap, the link is
+    // checked by whatever touches the program first
+    Entry &entry{this->programs[key]};
+    entry.program = std::make_unique<ShaderProgram>(ShaderProgram::fromFiles(
+        vertexShaderPath, fragmentShaderPath, defines, Link::DEFERRED));
+
+    return entry;
+}
+
+} // namespace opengl
+
+} // namespace mine
@@ -0,0 +1,107 @@
+#include "opengl/ShaderPreprocessor.hpp"
+#include "utils/fs.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+namespace mine {
+
+namespace opengl {
+
+namespace {
+
+struct Preprocessor {
+    // In include order, a file's index is its #line source number
+    std::vector<std::string> files;
+    std::string output;
+
+    void expand(const std::filesystem::path &path,
+                const ShaderDefines *defines);
+};
+
+bool startsWith(const std::string &line, const char *directive) {
+    std::size_t start{line.find_first_not_of(" \t")};
+
+    return start != std::string::npos &&
+           line.compare(start, std::char_traits<char>::length(directive),
+                        directive) == 0;
+}
+
+void Preprocessor::expand(const std::filesystem::path &path,
+                          const ShaderDefines *defines) {
+    std::size_t index{this->files.size()};
+    this->files.push_back(path.lexically_normal().string());
+
+    std::istringstream source{utils::fs::readFile(path.string().c_str())};
+
+    std::string line;
+    for (int number = 1; std::getline(source, line); number++) {
+        if (defines && startsWith(line, "#version")) {
+            this->output += line + "\n";
+
+            for (const std::string &define : *defines) {
+                this->output += "#define " + define + "\n";
+            }
+
+            this->output += "#line " + std::to_string(number + 1) + " " +
+                            std::to_string(index) + "\n";
+            continue;
+        }
+
+        if (!startsWith(line, "#include")) {
+            this->output += line + "\n";
+            continue;
+        }
+
+        std::size_t open{line.find('"')};
+        std::size_t close{line.rfind('"')};
+        if (open == std::string::npos || close == open) {
+            std::cerr << "Malformed #include in " << path.string() << ":"
+                      << number << std::endl;
+            exit(1);
+        }
+
+        std::filesystem::path included{
+            (path.parent_path() / line.substr(open + 1, close - open - 1))
+                .lexically_normal()};
+
+        bool seen{std::find(this->files.begin(), this->files.end(),
+                            included.string()) != this->files.end()};
+
+        if (!seen) {
+            this->output += "#line 1 " + std::to_string(this->files.size()) +
+                            "\n";
+            this->expand(included, nullptr);
+        }
+
+        this->output += "#line " + std::to_string(number + 1) + " " +
+                        std::to_string(index) + "\n";
+    }
+}
+
+} // namespace
+
+std::string preprocessShader(const char *path, const ShaderDefines &defines) {
+    Preprocessor preprocessor;
+    preprocessor.expand(path, &defines);
+
+    return std::move(preprocessor.output);
+}
+
+std::string definesKey(const ShaderDefines &defines) {
+    ShaderDefines sorted{defines};
+    std::sort(sorted.begin(), sorted.end());
+
+    std::string key;
+    for (const std::string &define : sorted) {
+        key += define + "\n";
+    }
+
+    return key;
+}
+
+} // namespace opengl
+
+} // namespace mine
@@ -1,25 +1,71 @@
 #include "opengl/ShaderProgram.hpp"
+#include "opengl/Extensions.hpp"
+#include "opengl/GLState.hpp"
 #include "utils/fs.hpp"
+#include "utils/hash.hpp"
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
 
 namespace mine {
 namespace opengl {
 
+namespace {
+
+std::string binaryCacheDirectory;
+
+struct BinaryHeader {
+    char magic[4];
+    std::uint32_t format;
+    std::uint64_t key;
+};
+
+constexpr char BINARY_MAGIC[4]{'M', 'P', 'R', 'G'};
+
 /**
- * @brief Create a Shader object
- *
- * @param type GLenum
- * @param source const char*
- *
- * @return unsigned int
+ * Cache key of a program, binaries only load on the driver that made them
  */
-unsigned int createShader(GLenum type, const char *source) {
+std::uint64_t hashSources(const char *vertexShader,
+                          const char *fragmentShader) {
+    using utils::hash::hashString;
+
+    std::uint64_t key{hashString(vertexShader)};
+    key = hashString(fragmentShader, key);
+
+    for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+        const GLubyte *value{glGetString(name)};
+        if (value) {
+            key = hashString(reinterpret_cast<const char *>(value), key);
+        }
+    }
+
+    return key;
+}
+
+std::string binaryPath(std::uint64_t key) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin",
+                  static_cast<unsigned long long>(key));
+
+    return binaryCacheDirectory + "/" + name;
+}
+
+/**
+ * Submit a compile without waiting for its status
+ */
+unsigned int compileShader(GLenum type, const char *source) {
     unsigned int shader = glCreateShader(type);
 
     glShaderSource(shader, 1, &source, NULL);
     glCompileShader(shader);
 
+    return shader;
+}
+
+void checkShader(unsigned int shader) {
     int success;
     glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
 
@@ -29,6 +75,33 @@ unsigned int createShader(GLenum type, const char *source) {
         std::cerr << "Failed to compile shader: " << infoLog << std::endl;
         exit(1);
     }
+}
+
+void checkProgram(unsigned int program) {
+    int success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+
+    if (!success) {
+        char infoLog[512];
+        glGetProgramInfoLog(program, 512, NULL, infoLog);
+        std::cerr << "Failed to link program: " << infoLog << std::endl;
+        exit(1);
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Create a Shader object
+ *
+ * @param type GLenum
+ * @param source const char*
+ *
+ * @return unsigned int
+ */
+unsigned int createShader(GLenum type, const char *source) {
+    unsigned int shader = compileShader(type, source);
+    checkShader(shader);
 
     return shader;
 }
@@ -43,24 +116,15 @@ unsigned int createShader(GLenum type, const char *source) {
  */
 unsigned int createProgram(const char *vertexShader,
                            const char *fragmentShader) {
-    unsigned int program = glCreateProgram();
-
     unsigned int vertex = createShader(GL_VERTEX_SHADER, vertexShader);
     unsigned int fragment = createShader(GL_FRAGMENT_SHADER, fragmentShader);
 
+    unsigned int program = glCreateProgram();
+
     glAttachShader(program, vertex);
     glAttachShader(program, fragment);
     glLinkProgram(program);
-
-    int success;
-    glGetProgramiv(program, GL_LINK_STATUS, &success);
-
-    if (!success) {
-        char infoLog[512];
-        glGetProgramInfoLog(program, 512, NULL, infoLog);
-        std::cerr << "Failed to link program: " << infoLog << std::endl;
-        exit(1);
-    }
+    checkProgram(program);
 
     glDeleteShader(vertex);
     glDeleteShader(fragment);
@@ -69,42 +133,278 @@ unsigned int createProgram(const char *vertexShader,
 }
 
 ShaderProgram ShaderProgram::fromFiles(const char *vertexShaderPath,
-                                       const char *fragmentShaderPath) {
-    using mine::utils::fs::readFile;
-
-    std::string vertexShader = readFile(vertexShaderPath);
-    std::string fragmentShader = readFile(fragmentShaderPath);
+                                       const char *fragmentShaderPath,
+                                       const ShaderDefines &defines,
+                                       Link link) {
+    std::string vertexShader = preprocessShader(vertexShaderPath, defines);
+    std::string fragmentShader = preprocessShader(fragmentShaderPath, defines);
 
-    return {vertexShader.c_str(), fragmentShader.c_str()};
+    return {vertexShader.c_str(), fragmentShader.c_str(), link};
 }
 
 ShaderProgram::ShaderProgram(const char *vertexShader,
-                             const char *fragmentShader)
-    : program{createProgram(vertexShader, fragmentShader)} {}
+                             const char *fragmentShader, Link link)
+    : program{0} {
+    this->load(vertexShader, fragmentShader);
+
+    if (link == Link::IMMEDIATE) {
+        this->finish();
+    }
+}
+
+void ShaderProgram::setBinaryCacheDirectory(std::string directory) {
+    binaryCacheDirectory = std::move(directory);
+}
 
-ShaderProgram::ShaderProgram(ShaderProgram &&other) : program{other.program} {
+ShaderProgram::ShaderProgram(ShaderProgram &&other)
+    : program{other.program}, fromBinaryCache{other.fromBinaryCache},
+      linked{other.linked}, vertexShader{other.vertexShader},
+      fragmentShader{other.fragmentShader}, saveBinary{other.saveBinary},
+      binaryKey{other.binaryKey}, uniforms{std::move(other.uniforms)} {
     other.program = 0;
+    other.vertexShader = 0;
+    other.fragmentShader = 0;
 }
 
 void ShaderProgram::operator=(ShaderProgram &&other) {
     if (this->program) {
+        GLState::get().forgetProgram(this->program);
         glDeleteProgram(this->program);
     }
 
+    if (this->vertexShader) {
+        glDeleteShader(this->vertexShader);
+        glDeleteShader(this->fragmentShader);
+    }
+
     this->program = other.program;
+    this->fromBinaryCache = other.fromBinaryCache;
+    this->linked = other.linked;
+    this->vertexShader = other.vertexShader;
+    this->fragmentShader = other.fragmentShader;
+    this->saveBinary = other.saveBinary;
+    this->binaryKey = other.binaryKey;
+    this->uniforms = std::move(other.uniforms);
+
     other.program = 0;
+    other.vertexShader = 0;
+    other.fragmentShader = 0;
 }
 
 ShaderProgram::~ShaderProgram() {
     if (this->program) {
+        GLState::get().forgetProgram(this->program);
         glDeleteProgram(this->program);
     }
+
+    if (this->vertexShader) {
+        glDeleteShader(this->vertexShader);
+        glDeleteShader(this->fragmentShader);
+    }
+}
+
+void ShaderProgram::use() {
+    this->finish();
+    GLState::get().useProgram(this->program);
+}
+
+void ShaderProgram::unuse() { GLState::get().useProgram(0); }
+
+unsigned int ShaderProgram::get() {
+    this->finish();
+    return this->program;
+}
+
+bool ShaderProgram::isFromBinaryCache() const { return this->fromBinaryCache; }
+
+Uniform ShaderProgram::getUniform(std::string_view name) {
+    this->finish();
+
+    std::uint32_t hash{hashUniformName(name)};
+
+    auto it{std::lower_bound(
+        this->uniforms.begin(), this->uniforms.end(), hash,
+        [](const CachedUniform &uniform, std::uint32_t value) {
+            return uniform.hash < value;
+        })};
+
+    for (; it != this->uniforms.end() && it->hash == hash; ++it) {
+        if (it->name == name) {
+            return {it->location};
+        }
+    }
+
+    return {};
 }
 
-void ShaderProgram::use() { glUseProgram(this->program); }
-void ShaderProgram::unuse() { glUseProgram(0); }
+void ShaderProgram::bindUniformBlock(const char *blockName,
+                                     GLuint bindingPoint) {
+    this->finish();
+
+    GLuint index{glGetUniformBlockIndex(this->program, blockName)};
+    if (index == GL_INVALID_INDEX) {
+        return;
+    }
+
+    glUniformBlockBinding(this->program, index, bindingPoint);
+}
+
+void ShaderProgram::cacheUniforms() {
+    this->uniforms.clear();
+
+    int count{0};
+    glGetProgramiv(this->program, GL_ACTIVE_UNIFORMS, &count);
+
+    int maxLength{0};
+    glGetProgramiv(this->program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
 
-unsigned int ShaderProgram::get() { return this->program; }
+    std::string name(static_cast<std::size_t>(maxLength), '\0');
+
+    for (int i = 0; i < count; i++) {
+        GLsizei length{0};
+        GLint size{0};
+        GLenum type{0};
+        glGetActiveUniform(this->program, static_cast<GLuint>(i), maxLength,
+                           &length, &size, &type, name.data());
+
+        std::string uniformName{name.data(), static_cast<std::size_t>(length)};
+
+        // Uniforms in blocks have no location
+        GLint location{
+            glGetUniformLocation(this->program, uniformName.c_str())};
+        if (location < 0) {
+            continue;
+        }
+
+        // Arrays are reported as "name[0]", allow looking them up as "name"
+        if (uniformName.size() > 3 &&
+            uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0) {
+            std::string baseName{uniformName.substr(0, uniformName.size() - 3)};
+            this->uniforms.push_back(
+                {hashUniformName(baseName), location, baseName});
+        }
+
+        this->uniforms.push_back(
+            {hashUniformName(uniformName), location, std::move(uniformName)});
+    }
+
+    std::sort(this->uniforms.begin(), this->uniforms.end(),
+              [](const CachedUniform &a, const CachedUniform &b) {
+                  return a.hash < b.hash;
+              });
+}
+
+void ShaderProgram::load(const char *vertexShader,
+                         const char *fragmentShader) {
+    const Extensions &extensions{getExtensions()};
+
+    this->saveBinary =
+        !binaryCacheDirectory.empty() && extensions.programBinary;
+
+    if (this->saveBinary) {
+        this->binaryKey = hashSources(vertexShader, fragmentShader);
+
+        std::vector<unsigned char> file;
+        if (utils::fs::readBinaryFile(binaryPath(this->binaryKey).c_str(),
+                                      file) &&
+            file.size() > sizeof(BinaryHeader)) {
+            BinaryHeader header;
+            std::memcpy(&header, file.data(), sizeof(header));
+
+            bool valid{std::memcmp(header.magic, BINARY_MAGIC,
+                                   sizeof(BINARY_MAGIC)) == 0 &&
+                       header.key == this->binaryKey};
+
+            if (valid) {
+                this->program = glCreateProgram();
+                extensions.programBinary(
+                    this->program, header.format, file.data() + sizeof(header),
+                    static_cast<GLsizei>(file.size() - sizeof(header)));
+
+                // Drivers reject binaries of other versions, compile instead
+                int success;
+                glGetProgramiv(this->program, GL_LINK_STATUS, &success);
+                if (success) {
+                    this->fromBinaryCache = true;
+                    this->saveBinary = false;
+                    return;
+                }
+
+                glDeleteProgram(this->program);
+            }
+        }
+    }
+
+    // Nothing is queried here, the driver may still be compiling when this
+    // returns
+    this->vertexShader = compileShader(GL_VERTEX_SHADER, vertexShader);
+    this->fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentShader);
+
+    this->program = glCreateProgram();
+
+    if (this->saveBinary) {
+        extensions.programParameteri(
+            this->program, PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    glAttachShader(this->program, this->vertexShader);
+    glAttachShader(this->program, this->fragmentShader);
+    glLinkProgram(this->program);
+}
+
+void ShaderProgram::finish() {
+    if (this->linked) {
+        return;
+    }
+
+    if (this->vertexShader) {
+        checkShader(this->vertexShader);
+        checkShader(this->fragmentShader);
+        checkProgram(this->program);
+
+        glDeleteShader(this->vertexShader);
+        glDeleteShader(this->fragmentShader);
+        this->vertexShader = 0;
+        this->fragmentShader = 0;
+    }
+
+    if (this->saveBinary) {
+        this->save();
+    }
+
+    this->cacheUniforms();
+    this->linked = true;
+}
+
+void ShaderProgram::save() {
+    GLint length{0};
+    glGetProgramiv(this->program, PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+
+    BinaryHeader header{};
+    std::memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    header.key = this->binaryKey;
+
+    std::vector<unsigned char> file(sizeof(header) +
+                                    static_cast<std::size_t>(length));
+
+    GLenum format{0};
+    getExtensions().getProgramBinary(this->program, length, nullptr, &format,
+                                     file.data() + sizeof(header));
+    header.format = format;
+    std::memcpy(file.data(), &header, sizeof(header));
+
+    // Not fatal, the program is simply compiled again next time
+    std::error_code error;
+    std::filesystem::create_directories(binaryCacheDirectory, error);
+
+    std::string path{binaryPath(this->binaryKey)};
+    if (!utils::fs::writeBinaryFile(path.c_str(), file.data(), file.size())) {
+        std::cerr << "Failed to write program binary: " << path << std::endl;
+    }
+}
 
 } // namespace opengl
 
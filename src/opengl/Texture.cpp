@@ -0,0 +1,64 @@
+#include "opengl/Texture.hpp"
+#include "opengl/GLState.hpp"
+
+#include <cassert>
+#include <iostream>
+
+namespace mine {
+
+namespace opengl {
+
+Texture::Texture(GLenum target) : target{target} {
+    glGenTextures(1, &this->id);
+    if (!this->id) {
+        std::cerr << "Failed to create texture" << std::endl;
+        exit(1);
+    }
+}
+
+Texture::Texture(Texture &&other) noexcept
+    : id{other.id}, target{other.target} {
+    other.id = 0;
+}
+
+void Texture::operator=(Texture &&other) noexcept {
+    if (this->id) {
+        GLState::get().forgetTexture(this->id);
+        glDeleteTextures(1, &this->id);
+    }
+
+    this->id = other.id;
+    this->target = other.target;
+
+    other.id = 0;
+}
+
+Texture::~Texture() {
+    if (this->id) {
+        GLState::get().forgetTexture(this->id);
+        glDeleteTextures(1, &this->id);
+    }
+}
+
+void Texture::bind(GLuint unit) {
+    assert(this->id);
+    GLState::get().bindTexture(unit, this->target, this->id);
+}
+
+void Texture::texBuffer(GLenum internalFormat, GLBuffer &buffer) {
+    assert(this->target == GL_TEXTURE_BUFFER);
+
+    this->bind();
+    glTexBuffer(GL_TEXTURE_BUFFER, internalFormat, buffer.get());
+}
+
+GLenum Texture::getTarget() const { return this->target; }
+
+unsigned int Texture::get() {
+    assert(this->id);
+    return this->id;
+}
+
+} // namespace opengl
+
+} // namespace mine
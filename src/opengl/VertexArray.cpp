@@ -1,4 +1,5 @@
 #include "opengl/VertexArray.hpp"
+#include "opengl/GLState.hpp"
 
 #include <cassert>
 #include <iostream>
@@ -21,18 +22,21 @@ VertexArray::VertexArray(std::function<void(VertexArray &)> setup) : VertexArray
     this->unbind();
 }
 
-VertexArray::VertexArray(VertexArray &&other) : id{other.id}, isBound{other.isBound} {
+VertexArray::VertexArray(VertexArray &&other)
+    : id{other.id}, isBound{other.isBound}, buffers{std::move(other.buffers)} {
     other.id = 0;
     other.isBound = false;
 }
 
 void VertexArray::operator=(VertexArray &&other) {
     if (this->id) {
+        GLState::get().forgetVertexArray(this->id);
         glDeleteVertexArrays(1, &this->id);
     }
 
     this->id = other.id;
     this->isBound = other.isBound;
+    this->buffers = std::move(other.buffers);
 
     other.id = 0;
     other.isBound = false;
@@ -40,18 +44,19 @@ void VertexArray::operator=(VertexArray &&other) {
 
 VertexArray::~VertexArray() {
     if (this->id) {
+        GLState::get().forgetVertexArray(this->id);
         glDeleteVertexArrays(1, &this->id);
     }
 }
 
 void VertexArray::bind() {
     this->isBound = true;
-    glBindVertexArray(this->id);
+    GLState::get().bindVertexArray(this->id);
 }
 
 void VertexArray::unbind() {
     this->isBound = false;
-    glBindVertexArray(0);
+    GLState::get().bindVertexArray(0);
 
     for (auto &buffer : this->buffers) {
         buffer->unbind();
@@ -66,6 +71,15 @@ void VertexArray::vertexAttribPointer(unsigned int index, int size, GLenum type,
     glEnableVertexAttribArray(index);
 }
 
+void VertexArray::vertexAttribIPointer(unsigned int index, int size,
+                                       GLenum type, int stride,
+                                       void *pointer) {
+    assert(this->isBound && "VAO is not bound");
+
+    glVertexAttribIPointer(index, size, type, stride, pointer);
+    glEnableVertexAttribArray(index);
+}
+
 GLBuffer &VertexArray::addBuffer(GLenum target) {
     this->buffers.emplace_back(std::make_unique<GLBuffer>(target));
     return *this->buffers.back();
@@ -1,29 +1,56 @@
 #include "opengl/gl_includes.hpp"
 #include "opengl/Window.hpp"
+#include "opengl/Extensions.hpp"
 
 #include <glm/fwd.hpp>
 #include <glm/ext.hpp>
 
 #include <cassert>
+#include <cstdlib>
 #include <iostream>
 
 namespace mine {
 
 namespace opengl {
 
-Window::Window(Window &&other) : window{other.window} {
+void preferHeadlessPlatform() {
+#ifdef GLFW_PLATFORM_NULL
+    if (!std::getenv("DISPLAY") && !std::getenv("WAYLAND_DISPLAY")) {
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    }
+#endif
+}
+
+Window::Window(Window &&other)
+    : window{other.window}, framebuffer{other.framebuffer},
+      colorBuffer{other.colorBuffer}, depthBuffer{other.depthBuffer},
+      framebufferWidth{other.framebufferWidth},
+      framebufferHeight{other.framebufferHeight} {
     other.window = nullptr;
+    other.framebuffer = 0;
+    other.colorBuffer = 0;
+    other.depthBuffer = 0;
 }
 
 void Window::operator=(Window &&other) {
     if (this->window) {
+        this->deleteFramebuffer();
         glfwDestroyWindow(this->window);
     }
     this->window = other.window;
+    this->framebuffer = other.framebuffer;
+    this->colorBuffer = other.colorBuffer;
+    this->depthBuffer = other.depthBuffer;
+    this->framebufferWidth = other.framebufferWidth;
+    this->framebufferHeight = other.framebufferHeight;
+
     other.window = nullptr;
+    other.framebuffer = 0;
+    other.colorBuffer = 0;
+    other.depthBuffer = 0;
 }
 
-Window::Window(const char *title, int width, int height) {
+Window::Window(const char *title, int width, int height, WindowMode mode) {
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
@@ -32,6 +59,9 @@ Window::Window(const char *title, int width, int height) {
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 #endif
 
+    bool headless{mode == WindowMode::HEADLESS};
+    glfwWindowHint(GLFW_VISIBLE, headless ? GLFW_FALSE : GLFW_TRUE);
+
     this->window = glfwCreateWindow(width, height, title, NULL, NULL);
     if (!this->window) {
         std::cerr << "Failed to create window" << std::endl;
@@ -45,13 +75,20 @@ Window::Window(const char *title, int width, int height) {
         exit(1);
     }
 
-    glfwSetInputMode(this->window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    loadExtensions((GLADloadproc)glfwGetProcAddress);
+
+    if (headless) {
+        this->createFramebuffer(width, height);
+    } else {
+        glfwSetInputMode(this->window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    }
 
     this->viewport(width, height);
 }
 
 Window::~Window() {
     if (this->window) {
+        this->deleteFramebuffer();
         glfwDestroyWindow(this->window);
     }
 }
@@ -63,12 +100,20 @@ void Window::setFramebufferSizeCallback(GLFWframebuffersizefun callback) {
 }
 
 int Window::getWidth() const {
+    if (this->framebuffer) {
+        return this->framebufferWidth;
+    }
+
     int width{0};
     glfwGetWindowSize(this->window, &width, nullptr);
 
     return width;
 }
 int Window::getHeight() const {
+    if (this->framebuffer) {
+        return this->framebufferHeight;
+    }
+
     int height{0};
     glfwGetWindowSize(this->window, nullptr, &height);
 
@@ -80,7 +125,16 @@ void Window::setHeight(int height) { this->viewport(this->getWidth(), height); }
 
 bool Window::shouldClose() const { return glfwWindowShouldClose(this->window); }
 
-void Window::swapBuffers() { glfwSwapBuffers(this->window); }
+void Window::swapBuffers() {
+    // Nothing presents headless frames, wait for them instead so they don't
+    // queue up without bound and frame times stay comparable
+    if (this->framebuffer) {
+        glFinish();
+        return;
+    }
+
+    glfwSwapBuffers(this->window);
+}
 void Window::pollEvents() { glfwPollEvents(); }
 
 bool Window::isKeyPressed(int key) {
@@ -97,12 +151,55 @@ glm::vec2 Window::getCursorPos() {
     };
 }
 
+bool Window::isHeadless() const { return this->framebuffer != 0; }
+
 GLFWwindow *Window::get() { return this->window; }
 
 void Window::viewport(int width, int height) {
     glViewport(0, 0, width, height);
 }
 
+void Window::createFramebuffer(int width, int height) {
+    this->framebufferWidth = width;
+    this->framebufferHeight = height;
+
+    glGenRenderbuffers(1, &this->colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, this->colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+    glGenRenderbuffers(1, &this->depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, this->depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &this->framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, this->framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                              GL_RENDERBUFFER, this->colorBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
+                              GL_RENDERBUFFER, this->depthBuffer);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Failed to create headless framebuffer" << std::endl;
+        exit(1);
+    }
+}
+
+void Window::deleteFramebuffer() {
+    if (!this->framebuffer) {
+        return;
+    }
+
+    // The context may not be current when windows are destroyed out of order
+    this->makeContextCurrent();
+
+    glDeleteFramebuffers(1, &this->framebuffer);
+    glDeleteRenderbuffers(1, &this->colorBuffer);
+    glDeleteRenderbuffers(1, &this->depthBuffer);
+    this->framebuffer = 0;
+}
+
 } // namespace opengl
 
 } // namespace mine
@@ -0,0 +1,220 @@
+#include "render/BlockTextures.hpp"
+#include "utils/fs.hpp"
+#include "utils/hash.hpp"
+#include "world/Block.hpp"
+
+#include <stb_image.h>
+
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+namespace mine {
+
+namespace render {
+
+namespace {
+
+constexpr std::size_t LAYERS{std::size(world::TEXTURE_FILES)};
+
+// Bump when the cache layout or the way levels are built changes
+constexpr std::uint32_t CACHE_VERSION{1};
+
+struct CacheHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t key;
+    std::uint32_t size;
+    std::uint32_t layers;
+    std::uint32_t levels;
+    std::uint32_t padding;
+};
+
+constexpr char CACHE_MAGIC[4]{'M', 'T', 'E', 'X'};
+
+std::size_t levelBytes(int level) {
+    std::size_t side{static_cast<std::size_t>(BlockTextures::SIZE >> level)};
+    return side * side * 4 * LAYERS;
+}
+
+std::size_t totalBytes() {
+    std::size_t bytes{0};
+    for (int level = 0; level < BlockTextures::LEVELS; level++) {
+        bytes += levelBytes(level);
+    }
+
+    return bytes;
+}
+
+/**
+ * Average 2x2 texels of an RGBA image of `side` texels into `out`
+ */
+void downsample(const unsigned char *in, int side, unsigned char *out) {
+    int half{side / 2};
+
+    for (int y = 0; y < half; y++) {
+        for (int x = 0; x < half; x++) {
+            for (int c = 0; c < 4; c++) {
+                int sum{in[((2 * y) * side + 2 * x) * 4 + c] +
+                        in[((2 * y) * side + 2 * x + 1) * 4 + c] +
+                        in[((2 * y + 1) * side + 2 * x) * 4 + c] +
+                        in[((2 * y + 1) * side + 2 * x + 1) * 4 + c]};
+
+                out[(y * half + x) * 4 + c] =
+                    static_cast<unsigned char>((sum + 2) / 4);
+            }
+        }
+    }
+}
+
+} // namespace
+
+BlockTextures::BlockTextures(const char *directory, const char *cachePath,
+                             jobs::JobSystem &jobSystem)
+    : texture{GL_TEXTURE_2D_ARRAY} {
+    static_assert(SIZE >> (LEVELS - 1) == 1, "LEVELS must reach 1x1");
+
+    std::vector<std::vector<unsigned char>> sources(LAYERS);
+
+    std::uint64_t key{utils::hash::FNV_OFFSET};
+    for (std::size_t i = 0; i < LAYERS; i++) {
+        std::string path{std::string{directory} + "/" +
+                         world::TEXTURE_FILES[i]};
+
+        if (!utils::fs::readBinaryFile(path.c_str(), sources[i])) {
+            std::cerr << "Failed to open texture: " << path << std::endl;
+            exit(1);
+        }
+
+        key = utils::hash::hashString(world::TEXTURE_FILES[i], key);
+        key = utils::hash::hashBytes(sources[i].data(), sources[i].size(),
+                                     key);
+    }
+
+    std::vector<unsigned char> cache;
+    if (utils::fs::readBinaryFile(cachePath, cache) &&
+        cache.size() == sizeof(CacheHeader) + totalBytes()) {
+        CacheHeader header;
+        std::memcpy(&header, cache.data(), sizeof(header));
+
+        this->fromCache =
+            std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 &&
+            header.version == CACHE_VERSION && header.key == key &&
+            header.size == SIZE && header.layers == LAYERS &&
+            header.levels == LEVELS;
+    }
+
+    if (this->fromCache) {
+        this->upload(cache.data() + sizeof(CacheHeader));
+        return;
+    }
+
+    std::vector<unsigned char> pixels{decode(sources, jobSystem)};
+    this->upload(pixels.data());
+
+    CacheHeader header{};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.key = key;
+    header.size = SIZE;
+    header.layers = LAYERS;
+    header.levels = LEVELS;
+
+    cache.resize(sizeof(CacheHeader));
+    std::memcpy(cache.data(), &header, sizeof(header));
+    cache.insert(cache.end(), pixels.begin(), pixels.end());
+
+    // Not fatal, the next startup decodes again
+    if (!utils::fs::writeBinaryFile(cachePath, cache.data(), cache.size())) {
+        std::cerr << "Failed to write texture cache: " << cachePath
+                  << std::endl;
+    }
+}
+
+void BlockTextures::bind() { this->texture.bind(UNIT); }
+
+bool BlockTextures::isFromCache() const { return this->fromCache; }
+
+std::vector<unsigned char>
+BlockTextures::decode(const std::vector<std::vector<unsigned char>> &sources,
+                      jobs::JobSystem &jobSystem) {
+    std::vector<unsigned char> pixels(totalBytes());
+    std::vector<std::string> errors(LAYERS);
+
+    jobSystem.parallelFor(LAYERS, [&](std::size_t layer) {
+        const auto &source{sources[layer]};
+
+        int width;
+        int height;
+        int channels;
+        unsigned char *image{stbi_load_from_memory(
+            source.data(), static_cast<int>(source.size()), &width, &height,
+            &channels, 4)};
+
+        if (!image) {
+            errors[layer] = stbi_failure_reason();
+            return;
+        }
+
+        if (width != SIZE || height != SIZE) {
+            errors[layer] = "expected " + std::to_string(SIZE) + "x" +
+                            std::to_string(SIZE) + " pixels";
+            stbi_image_free(image);
+            return;
+        }
+
+        // Each layer owns a disjoint slice of every level
+        std::size_t offset{0};
+        const unsigned char *previous{image};
+
+        for (int level = 0; level < LEVELS; level++) {
+            int side{SIZE >> level};
+            std::size_t layerBytes{static_cast<std::size_t>(side * side * 4)};
+            unsigned char *out{pixels.data() + offset + layer * layerBytes};
+
+            if (level == 0) {
+                std::memcpy(out, image, layerBytes);
+            } else {
+                downsample(previous, side * 2, out);
+            }
+
+            previous = out;
+            offset += levelBytes(level);
+        }
+
+        stbi_image_free(image);
+    });
+
+    for (std::size_t i = 0; i < LAYERS; i++) {
+        if (!errors[i].empty()) {
+            std::cerr << "Failed to decode texture " << world::TEXTURE_FILES[i]
+                      << ": " << errors[i] << std::endl;
+            exit(1);
+        }
+    }
+
+    return pixels;
+}
+
+void BlockTextures::upload(const unsigned char *pixels) {
+    this->texture.bind(UNIT);
+
+    for (int level = 0; level < LEVELS; level++) {
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA8, SIZE >> level,
+                     SIZE >> level, static_cast<GLsizei>(LAYERS), 0, GL_RGBA,
+                     GL_UNSIGNED_BYTE, pixels);
+
+        pixels += levelBytes(level);
+    }
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER,
+                    GL_NEAREST_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, LEVELS - 1);
+}
+
+} // namespace render
+
+} // namespace mine
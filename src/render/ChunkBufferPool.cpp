@@ -0,0 +1,372 @@
+#include "render/ChunkBufferPool.hpp"
+#include "opengl/Extensions.hpp"
+#include "opengl/GLState.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace mine {
+
+namespace render {
+
+namespace {
+
+constexpr std::size_t VERTEX_SIZE{sizeof(ChunkVertex)};
+constexpr std::size_t INDEX_SIZE{sizeof(unsigned int)};
+
+} // namespace
+
+ChunkBufferPool::ChunkBufferPool(std::size_t vertexCapacity,
+                                 std::size_t indexCapacity)
+    : vao{createVertexArray(pagesFor(vertexCapacity) * PAGE_SIZE,
+                            indexCapacity)},
+      originsBuffer{GL_TEXTURE_BUFFER}, originsTexture{GL_TEXTURE_BUFFER},
+      pages{pagesFor(vertexCapacity)}, indices{indexCapacity},
+      indirectBuffer{opengl::DRAW_INDIRECT_BUFFER} {
+    this->resizeOrigins(this->pages.getCapacity());
+}
+
+ChunkBufferPool::Handle ChunkBufferPool::allocate(const MeshData &data,
+                                                  glm::ivec3 origin) {
+    assert(!data.empty());
+
+    Handle handle;
+    if (!this->freeHandles.empty()) {
+        handle = this->freeHandles.back();
+        this->freeHandles.pop_back();
+    } else {
+        handle = static_cast<Handle>(this->slots.size());
+        this->slots.emplace_back();
+    }
+
+    if (!this->reserve(this->slots[handle], data)) {
+        std::size_t pagesNeeded{this->pages.getUsed() +
+                                pagesFor(data.vertices.size())};
+        std::size_t indexNeeded{this->indices.getUsed() + data.indices.size()};
+
+        // Compact in place if the space is there but fragmented, otherwise
+        // grow so that the pool ends up at most half full
+        std::size_t pageCapacity{this->pages.getCapacity()};
+        while (pageCapacity < pagesNeeded * 2) {
+            pageCapacity *= 2;
+        }
+
+        std::size_t indexCapacity{this->indices.getCapacity()};
+        while (indexCapacity < indexNeeded * 2) {
+            indexCapacity *= 2;
+        }
+
+        this->compact(pageCapacity * PAGE_SIZE, indexCapacity);
+
+        bool reserved{this->reserve(this->slots[handle], data)};
+        assert(reserved && "Compaction must leave room for the mesh");
+        (void)reserved;
+    }
+
+    this->slots[handle].origin = origin;
+    this->write(this->slots[handle], data);
+
+    return handle;
+}
+
+void ChunkBufferPool::free(Handle handle) {
+    if (handle == INVALID_HANDLE) {
+        return;
+    }
+
+    assert(handle < this->slots.size() && this->slots[handle].live);
+
+    Slot &slot{this->slots[handle]};
+    this->pages.free(slot.allocation.vertexOffset / PAGE_SIZE,
+                     slot.pagesReserved);
+    this->indices.free(slot.allocation.indexOffset, slot.indexReserved);
+
+    slot = {};
+    this->freeHandles.push_back(handle);
+}
+
+ChunkBufferPool::Handle ChunkBufferPool::update(Handle handle,
+                                                const MeshData &data,
+                                                glm::ivec3 origin) {
+    if (data.empty()) {
+        this->free(handle);
+        return INVALID_HANDLE;
+    }
+
+    if (handle == INVALID_HANDLE) {
+        return this->allocate(data, origin);
+    }
+
+    Slot &slot{this->slots[handle]};
+    if (pagesFor(data.vertices.size()) <= slot.pagesReserved &&
+        data.indices.size() <= slot.indexReserved) {
+        slot.origin = origin;
+        this->write(slot, data);
+        return handle;
+    }
+
+    this->free(handle);
+    return this->allocate(data, origin);
+}
+
+const MeshAllocation &ChunkBufferPool::get(Handle handle) const {
+    assert(handle < this->slots.size() && this->slots[handle].live);
+    return this->slots[handle].allocation;
+}
+
+void ChunkBufferPool::compact(std::size_t vertexCapacity,
+                              std::size_t indexCapacity) {
+    std::size_t pageCapacity{pagesFor(vertexCapacity)};
+
+    opengl::VertexArray compacted{
+        createVertexArray(pageCapacity * PAGE_SIZE, indexCapacity)};
+
+    this->pages.reset(pageCapacity);
+    this->indices.reset(indexCapacity);
+
+    opengl::GLState &state{opengl::GLState::get()};
+    state.bindBuffer(GL_COPY_READ_BUFFER, this->vao.getBuffer(0).get());
+    state.bindBuffer(GL_COPY_WRITE_BUFFER, compacted.getBuffer(0).get());
+
+    // Drop the slack of reused ranges while we are at it
+    for (auto &slot : this->slots) {
+        if (!slot.live) {
+            continue;
+        }
+
+        MeshAllocation &allocation{slot.allocation};
+        slot.pagesReserved = pagesFor(allocation.vertexCount);
+
+        std::size_t offset{*this->pages.allocate(slot.pagesReserved) *
+                           PAGE_SIZE};
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                            allocation.vertexOffset * VERTEX_SIZE,
+                            offset * VERTEX_SIZE,
+                            allocation.vertexCount * VERTEX_SIZE);
+
+        allocation.vertexOffset = offset;
+    }
+
+    state.bindBuffer(GL_COPY_READ_BUFFER, this->vao.getBuffer(1).get());
+    state.bindBuffer(GL_COPY_WRITE_BUFFER, compacted.getBuffer(1).get());
+
+    for (auto &slot : this->slots) {
+        if (!slot.live) {
+            continue;
+        }
+
+        MeshAllocation &allocation{slot.allocation};
+
+        std::size_t offset{*this->indices.allocate(allocation.indexCount)};
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                            allocation.indexOffset * INDEX_SIZE,
+                            offset * INDEX_SIZE,
+                            allocation.indexCount * INDEX_SIZE);
+
+        allocation.indexOffset = offset;
+        slot.indexReserved = allocation.indexCount;
+    }
+
+    this->vao = std::move(compacted);
+
+    this->pageOrigins.assign(pageCapacity, glm::ivec4{0});
+    for (auto &slot : this->slots) {
+        if (!slot.live) {
+            continue;
+        }
+
+        std::size_t first{slot.allocation.vertexOffset / PAGE_SIZE};
+        std::fill_n(this->pageOrigins.begin() + first, slot.pagesReserved,
+                    glm::ivec4{slot.origin, 0});
+    }
+
+    this->resizeOrigins(pageCapacity);
+}
+
+void ChunkBufferPool::bind() {
+    this->vao.bind();
+    this->originsTexture.bind(ORIGINS_UNIT);
+}
+
+void ChunkBufferPool::draw(Handle handle) {
+    const MeshAllocation &allocation{this->get(handle)};
+
+    glDrawElementsBaseVertex(
+        GL_TRIANGLES, static_cast<GLsizei>(allocation.indexCount),
+        GL_UNSIGNED_INT,
+        reinterpret_cast<void *>(allocation.indexOffset * INDEX_SIZE),
+        static_cast<GLint>(allocation.vertexOffset));
+}
+
+void ChunkBufferPool::draw(const std::vector<Handle> &handles,
+                           DrawPath path) {
+    if (handles.empty()) {
+        return;
+    }
+
+    if (path == DrawPath::MULTI_DRAW_INDIRECT && !supportsIndirect()) {
+        path = DrawPath::MULTI_DRAW;
+    }
+
+    switch (path) {
+    case DrawPath::PER_MESH:
+        for (Handle handle : handles) {
+            this->draw(handle);
+        }
+        break;
+
+    case DrawPath::MULTI_DRAW:
+        this->counts.clear();
+        this->indexOffsets.clear();
+        this->baseVertices.clear();
+
+        for (Handle handle : handles) {
+            const MeshAllocation &allocation{this->get(handle)};
+
+            this->counts.push_back(
+                static_cast<GLsizei>(allocation.indexCount));
+            this->indexOffsets.push_back(
+                reinterpret_cast<void *>(allocation.indexOffset * INDEX_SIZE));
+            this->baseVertices.push_back(
+                static_cast<GLint>(allocation.vertexOffset));
+        }
+
+        glMultiDrawElementsBaseVertex(
+            GL_TRIANGLES, this->counts.data(), GL_UNSIGNED_INT,
+            this->indexOffsets.data(),
+            static_cast<GLsizei>(this->counts.size()),
+            this->baseVertices.data());
+        break;
+
+    case DrawPath::MULTI_DRAW_INDIRECT:
+        this->commands.clear();
+
+        for (Handle handle : handles) {
+            const MeshAllocation &allocation{this->get(handle)};
+
+            this->commands.push_back(
+                {static_cast<GLuint>(allocation.indexCount), 1,
+                 static_cast<GLuint>(allocation.indexOffset),
+                 static_cast<GLint>(allocation.vertexOffset), 0});
+        }
+
+        // Orphan last frame's commands rather than waiting on them
+        this->indirectBuffer.bufferData(
+            static_cast<GLsizeiptr>(this->commands.size() *
+                                    sizeof(IndirectCommand)),
+            this->commands.data(), GL_STREAM_DRAW);
+
+        opengl::getExtensions().multiDrawElementsIndirect(
+            GL_TRIANGLES, GL_UNSIGNED_INT, nullptr,
+            static_cast<GLsizei>(this->commands.size()), 0);
+        break;
+    }
+}
+
+bool ChunkBufferPool::supportsIndirect() {
+    return opengl::getExtensions().multiDrawElementsIndirect != nullptr;
+}
+
+opengl::VertexArray &ChunkBufferPool::getVertexArray() { return this->vao; }
+
+std::size_t ChunkBufferPool::getVertexCapacity() const {
+    return this->pages.getCapacity() * PAGE_SIZE;
+}
+
+std::size_t ChunkBufferPool::getIndexCapacity() const {
+    return this->indices.getCapacity();
+}
+
+std::size_t ChunkBufferPool::getUsedBytes() const {
+    return this->pages.getUsed() * PAGE_SIZE * VERTEX_SIZE +
+           this->indices.getUsed() * INDEX_SIZE;
+}
+
+float ChunkBufferPool::getFragmentation() const {
+    return std::max(this->pages.getFragmentation(),
+                    this->indices.getFragmentation());
+}
+
+opengl::VertexArray
+ChunkBufferPool::createVertexArray(std::size_t vertexCapacity,
+                                   std::size_t indexCapacity) {
+    return opengl::VertexArray{[=](opengl::VertexArray &vao) {
+        auto &vbo{vao.addBuffer()};
+        auto &ebo{vao.addBuffer(GL_ELEMENT_ARRAY_BUFFER)};
+
+        vbo.bufferData(vertexCapacity * VERTEX_SIZE, nullptr, GL_DYNAMIC_DRAW);
+        ebo.bufferData(indexCapacity * INDEX_SIZE, nullptr, GL_DYNAMIC_DRAW);
+
+        vao.vertexAttribIPointer(
+            0, 1, GL_UNSIGNED_INT, sizeof(ChunkVertex),
+            reinterpret_cast<void *>(offsetof(ChunkVertex, data)));
+    }};
+}
+
+std::size_t ChunkBufferPool::pagesFor(std::size_t vertexCount) {
+    return (vertexCount + PAGE_SIZE - 1) / PAGE_SIZE;
+}
+
+bool ChunkBufferPool::reserve(Slot &slot, const MeshData &data) {
+    std::size_t pageCount{pagesFor(data.vertices.size())};
+
+    auto page{this->pages.allocate(pageCount)};
+    if (!page) {
+        return false;
+    }
+
+    auto indexOffset{this->indices.allocate(data.indices.size())};
+    if (!indexOffset) {
+        this->pages.free(*page, pageCount);
+        return false;
+    }
+
+    slot.allocation.vertexOffset = *page * PAGE_SIZE;
+    slot.allocation.indexOffset = *indexOffset;
+    slot.pagesReserved = pageCount;
+    slot.indexReserved = data.indices.size();
+    slot.live = true;
+
+    return true;
+}
+
+void ChunkBufferPool::write(Slot &slot, const MeshData &data) {
+    MeshAllocation &allocation{slot.allocation};
+    allocation.vertexCount = data.vertices.size();
+    allocation.indexCount = data.indices.size();
+
+    // The element buffer binding belongs to the bound vertex array, make
+    // sure it is ours
+    this->vao.bind();
+
+    this->vao.getBuffer(0).bufferSubData(
+        static_cast<GLintptr>(allocation.vertexOffset * VERTEX_SIZE),
+        static_cast<GLsizeiptr>(data.vertices.size() * VERTEX_SIZE),
+        data.vertices.data());
+    this->vao.getBuffer(1).bufferSubData(
+        static_cast<GLintptr>(allocation.indexOffset * INDEX_SIZE),
+        static_cast<GLsizeiptr>(data.indices.size() * INDEX_SIZE),
+        data.indices.data());
+
+    std::size_t first{allocation.vertexOffset / PAGE_SIZE};
+    std::fill_n(this->pageOrigins.begin() + first, slot.pagesReserved,
+                glm::ivec4{slot.origin, 0});
+
+    this->originsBuffer.bufferSubData(
+        static_cast<GLintptr>(first * sizeof(glm::ivec4)),
+        static_cast<GLsizeiptr>(slot.pagesReserved * sizeof(glm::ivec4)),
+        this->pageOrigins.data() + first);
+}
+
+void ChunkBufferPool::resizeOrigins(std::size_t pageCapacity) {
+    this->pageOrigins.resize(pageCapacity, glm::ivec4{0});
+
+    this->originsBuffer.bufferData(
+        static_cast<GLsizeiptr>(pageCapacity * sizeof(glm::ivec4)),
+        this->pageOrigins.data(), GL_DYNAMIC_DRAW);
+    this->originsTexture.texBuffer(GL_RGBA32I, this->originsBuffer);
+}
+
+} // namespace render
+
+} // namespace mine
@@ -0,0 +1,474 @@
+#include "render/ChunkMesher.hpp"
+#include "utils/bits.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace mine {
+
+namespace render {
+
+namespace {
+
+/**
+ * A block face: the axis it faces along, its direction on that axis, and the
+ * two in-plane axes chosen so that u x v points out of the block. Corners
+ * emitted as origin, u, u + v, v are then counter-clockwise seen from outside.
+ *
+ * `normal` is the index stored in ChunkVertex, shaders/vertex.glsl relies on
+ * this order.
+ */
+struct Face {
+    int axis;
+    int direction;
+    int u;
+    int v;
+    unsigned int normal;
+};
+
+constexpr std::array<Face, 6> FACES{{
+    {0, -1, 2, 1, 0}, // -X
+    {0, 1, 1, 2, 1},  // +X
+    {1, -1, 0, 2, 2}, // -Y
+    {1, 1, 2, 0, 3},  // +Y
+    {2, -1, 1, 0, 4}, // -Z
+    {2, 1, 0, 1, 5},  // +Z
+}};
+
+// Every corner unoccluded, see faceOcclusion
+constexpr std::uint8_t NO_OCCLUSION{0xff};
+
+/**
+ * Ambient occlusion of a block face's corners, 2 bits each in the corner
+ * order of emitQuad, from 0 (darkest) to 3 (open). A corner darkens for
+ * each solid block touching it in the layer in front of the face, and is
+ * fully dark when both of its edges are blocked.
+ */
+std::uint8_t faceOcclusion(const PaddedSection &section, const Face &face,
+                           glm::ivec3 block) {
+    glm::ivec3 front{block};
+    front[face.axis] += face.direction;
+
+    auto solid{[&section](glm::ivec3 position) {
+        return world::isTransparent(
+                   section.get(position.x, position.y, position.z))
+                   ? 0
+                   : 1;
+    }};
+
+    constexpr int SIGNS[4][2]{{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+
+    std::uint8_t occlusion{0};
+    for (int corner = 0; corner < 4; corner++) {
+        glm::ivec3 u{front};
+        glm::ivec3 v{front};
+        u[face.u] += SIGNS[corner][0];
+        v[face.v] += SIGNS[corner][1];
+
+        glm::ivec3 diagonal{u};
+        diagonal[face.v] += SIGNS[corner][1];
+
+        int sideU{solid(u)};
+        int sideV{solid(v)};
+        int ao{sideU && sideV ? 0 : 3 - sideU - sideV - solid(diagonal)};
+
+        occlusion |= static_cast<std::uint8_t>(ao << (corner * 2));
+    }
+
+    return occlusion;
+}
+
+/**
+ * Emit a quad covering `width` blocks along the face's u axis and `height`
+ * blocks along its v axis, starting at `block`. Merged quads must share the
+ * same corner occlusion.
+ */
+void emitQuad(MeshData &out, const Face &face, glm::ivec3 block,
+              world::BlockId id, int width = 1, int height = 1,
+              std::uint8_t occlusion = NO_OCCLUSION) {
+    glm::ivec3 origin{block};
+    if (face.direction > 0) {
+        origin[face.axis] += 1;
+    }
+
+    glm::ivec3 u{0};
+    glm::ivec3 v{0};
+    u[face.u] = width;
+    v[face.v] = height;
+
+    glm::ivec3 corners[4]{origin, origin + u, origin + u + v, origin + v};
+
+    unsigned int layer{world::textureLayer(id)};
+
+    unsigned int ao[4];
+    for (int corner = 0; corner < 4; corner++) {
+        ao[corner] = (occlusion >> (corner * 2)) & 3;
+    }
+
+    unsigned int base{static_cast<unsigned int>(out.vertices.size())};
+    for (int corner = 0; corner < 4; corner++) {
+        out.vertices.push_back(ChunkVertex::pack(
+            static_cast<unsigned int>(corners[corner].x),
+            static_cast<unsigned int>(corners[corner].y),
+            static_cast<unsigned int>(corners[corner].z), face.normal, layer,
+            ao[corner]));
+    }
+
+    // Split along the diagonal with the lighter ends, otherwise the
+    // interpolation shows the triangles as a dark crease
+    if (ao[0] + ao[2] < ao[1] + ao[3]) {
+        out.indices.insert(out.indices.end(), {base + 1, base + 2, base + 3,
+                                               base + 1, base + 3, base});
+    } else {
+        out.indices.insert(out.indices.end(), {base, base + 1, base + 2, base,
+                                               base + 2, base + 3});
+    }
+}
+
+} // namespace
+
+ChunkMesher::ChunkMesher(MeshingMode mode) : mode{mode} {}
+
+void MeshData::clear() {
+    this->vertices.clear();
+    this->indices.clear();
+}
+
+bool MeshData::empty() const { return this->indices.empty(); }
+
+PaddedSection PaddedSection::gather(const world::World &world,
+                                    glm::ivec3 chunkPosition) {
+    constexpr int CHUNK_SIZE{world::Chunk::SIZE};
+
+    // The 3x3x3 block of chunks overlapping the padded region
+    const world::Chunk *chunks[3][3][3];
+    for (int y = 0; y < 3; y++) {
+        for (int z = 0; z < 3; z++) {
+            for (int x = 0; x < 3; x++) {
+                chunks[y][z][x] = world.getChunk(
+                    chunkPosition + glm::ivec3{x - 1, y - 1, z - 1});
+            }
+        }
+    }
+
+    auto chunkIndex = [](int coord) {
+        return coord < 0 ? 0 : (coord >= CHUNK_SIZE ? 2 : 1);
+    };
+
+    PaddedSection section;
+
+    const world::Chunk *center{chunks[1][1][1]};
+    section.empty = !center || center->getSection().isEmpty();
+
+    for (int y = -1; y <= CHUNK_SIZE; y++) {
+        int cy{chunkIndex(y)};
+        int ly{world::toLocalCoord(y)};
+
+        for (int z = -1; z <= CHUNK_SIZE; z++) {
+            int cz{chunkIndex(z)};
+            int lz{world::toLocalCoord(z)};
+
+            for (int x = -1; x <= CHUNK_SIZE; x++) {
+                const world::Chunk *chunk{chunks[cy][cz][chunkIndex(x)]};
+                if (!chunk) {
+                    continue;
+                }
+
+                section.set(x, y, z,
+                            chunk->getBlock(world::toLocalCoord(x), ly, lz));
+            }
+        }
+    }
+
+    return section;
+}
+
+void ChunkMesher::meshCulled(const PaddedSection &section,
+                             MeshData &out) const {
+    out.clear();
+
+    if (section.isEmpty()) {
+        return;
+    }
+
+    for (int y = 0; y < world::Chunk::SIZE; y++) {
+        for (int z = 0; z < world::Chunk::SIZE; z++) {
+            for (int x = 0; x < world::Chunk::SIZE; x++) {
+                world::BlockId block{section.get(x, y, z)};
+                if (world::isTransparent(block)) {
+                    continue;
+                }
+
+                for (const Face &face : FACES) {
+                    glm::ivec3 neighbour{x, y, z};
+                    neighbour[face.axis] += face.direction;
+
+                    if (world::isTransparent(section.get(
+                            neighbour.x, neighbour.y, neighbour.z))) {
+                        emitQuad(out, face, {x, y, z}, block, 1, 1,
+                                 faceOcclusion(section, face, {x, y, z}));
+                    }
+                }
+            }
+        }
+    }
+}
+
+void ChunkMesher::meshGreedy(const PaddedSection &section,
+                             MeshData &out) const {
+    constexpr int SIZE{world::Chunk::SIZE};
+
+    out.clear();
+
+    if (section.isEmpty()) {
+        return;
+    }
+
+    // Block of each visible face in the current slice in the low 16 bits and
+    // its corner occlusion above, 0 where there is none, indexed [v][u].
+    // Only faces with equal values merge.
+    std::uint32_t mask[SIZE][SIZE];
+
+    for (const Face &face : FACES) {
+        for (int slice = 0; slice < SIZE; slice++) {
+            bool anyFace{false};
+
+            for (int v = 0; v < SIZE; v++) {
+                for (int u = 0; u < SIZE; u++) {
+                    glm::ivec3 position{0};
+                    position[face.axis] = slice;
+                    position[face.u] = u;
+                    position[face.v] = v;
+
+                    world::BlockId block{
+                        section.get(position.x, position.y, position.z)};
+
+                    glm::ivec3 neighbour{position};
+                    neighbour[face.axis] += face.direction;
+
+                    bool visible{!world::isTransparent(block) &&
+                                 world::isTransparent(section.get(
+                                     neighbour.x, neighbour.y, neighbour.z))};
+
+                    mask[v][u] = 0;
+                    if (visible) {
+                        std::uint32_t occlusion{
+                            faceOcclusion(section, face, position)};
+                        mask[v][u] = block | occlusion << 16;
+                    }
+                    anyFace |= visible;
+                }
+            }
+
+            if (!anyFace) {
+                continue;
+            }
+
+            for (int v = 0; v < SIZE; v++) {
+                for (int u = 0; u < SIZE;) {
+                    std::uint32_t value{mask[v][u]};
+                    if (!value) {
+                        u++;
+                        continue;
+                    }
+
+                    int width{1};
+                    while (u + width < SIZE && mask[v][u + width] == value) {
+                        width++;
+                    }
+
+                    int height{1};
+                    for (; v + height < SIZE; height++) {
+                        bool rowMatches{true};
+                        for (int k = 0; k < width; k++) {
+                            if (mask[v + height][u + k] != value) {
+                                rowMatches = false;
+                                break;
+                            }
+                        }
+
+                        if (!rowMatches) {
+                            break;
+                        }
+                    }
+
+                    for (int dv = 0; dv < height; dv++) {
+                        for (int du = 0; du < width; du++) {
+                            mask[v + dv][u + du] = 0;
+                        }
+                    }
+
+                    glm::ivec3 position{0};
+                    position[face.axis] = slice;
+                    position[face.u] = u;
+                    position[face.v] = v;
+
+                    emitQuad(out, face, position,
+                             static_cast<world::BlockId>(value & 0xffff),
+                             width, height,
+                             static_cast<std::uint8_t>(value >> 16));
+
+                    u += width;
+                }
+            }
+        }
+    }
+}
+
+void ChunkMesher::meshBinary(const PaddedSection &section,
+                             MeshData &out) const {
+    using utils::bits::countTrailingZeros;
+
+    constexpr int SIZE{world::Chunk::SIZE};
+    constexpr int PADDED{PaddedSection::SIZE};
+
+    static_assert(PADDED <= 32, "Columns must fit in 32 bits");
+
+    out.clear();
+
+    if (section.isEmpty()) {
+        return;
+    }
+
+    // columns[axis][high][low] has bit i set when the block at padded
+    // coordinate i along `axis` is solid. `low` and `high` are the padded
+    // coordinates on the other two axes, in increasing axis order.
+    std::uint32_t columns[3][PADDED][PADDED]{};
+
+    for (int y = 0; y < PADDED; y++) {
+        for (int z = 0; z < PADDED; z++) {
+            for (int x = 0; x < PADDED; x++) {
+                if (world::isTransparent(section.get(x - 1, y - 1, z - 1))) {
+                    continue;
+                }
+
+                columns[0][z][y] |= std::uint32_t{1} << x;
+                columns[1][z][x] |= std::uint32_t{1} << y;
+                columns[2][y][x] |= std::uint32_t{1} << z;
+            }
+        }
+    }
+
+    // Visible faces of one block type and corner occlusion in one face
+    // direction, indexed [slice][v] with one bit per u coordinate
+    struct Planes {
+        world::BlockId block;
+        std::uint8_t occlusion;
+        std::uint32_t rows[SIZE][SIZE];
+    };
+
+    std::vector<Planes> planes;
+
+    for (const Face &face : FACES) {
+        int lowAxis{face.axis == 0 ? 1 : 0};
+        int highAxis{face.axis == 2 ? 1 : 2};
+
+        planes.clear();
+
+        for (int high = 1; high <= SIZE; high++) {
+            for (int low = 1; low <= SIZE; low++) {
+                std::uint32_t column{columns[face.axis][high][low]};
+
+                // Solid blocks whose neighbour in the face direction is not
+                std::uint32_t visible{face.direction > 0
+                                          ? column & ~(column >> 1)
+                                          : column & ~(column << 1)};
+
+                // Drop the padding, bit i is now chunk coordinate i
+                visible = (visible >> 1) & ((std::uint32_t{1} << SIZE) - 1);
+
+                while (visible) {
+                    int slice{countTrailingZeros(visible)};
+                    visible &= visible - 1;
+
+                    glm::ivec3 position{0};
+                    position[face.axis] = slice;
+                    position[lowAxis] = low - 1;
+                    position[highAxis] = high - 1;
+
+                    world::BlockId block{
+                        section.get(position.x, position.y, position.z)};
+                    std::uint8_t occlusion{
+                        faceOcclusion(section, face, position)};
+
+                    Planes *target{nullptr};
+                    for (auto &candidate : planes) {
+                        if (candidate.block == block &&
+                            candidate.occlusion == occlusion) {
+                            target = &candidate;
+                            break;
+                        }
+                    }
+
+                    if (!target) {
+                        target = &planes.emplace_back();
+                        target->block = block;
+                        target->occlusion = occlusion;
+                        std::fill(&target->rows[0][0],
+                                  &target->rows[0][0] + SIZE * SIZE, 0);
+                    }
+
+                    target->rows[slice][position[face.v]] |=
+                        std::uint32_t{1} << position[face.u];
+                }
+            }
+        }
+
+        for (auto &plane : planes) {
+            for (int slice = 0; slice < SIZE; slice++) {
+                std::uint32_t(&rows)[SIZE]{plane.rows[slice]};
+
+                for (int v = 0; v < SIZE; v++) {
+                    while (rows[v]) {
+                        int u{countTrailingZeros(rows[v])};
+                        int width{countTrailingZeros(~(rows[v] >> u))};
+
+                        std::uint32_t span{((std::uint32_t{1} << width) - 1)
+                                           << u};
+
+                        int height{1};
+                        while (v + height < SIZE &&
+                               (rows[v + height] & span) == span) {
+                            rows[v + height] &= ~span;
+                            height++;
+                        }
+
+                        rows[v] &= ~span;
+
+                        glm::ivec3 position{0};
+                        position[face.axis] = slice;
+                        position[face.u] = u;
+                        position[face.v] = v;
+
+                        emitQuad(out, face, position, plane.block, width,
+                                 height, plane.occlusion);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void ChunkMesher::mesh(const PaddedSection &section, MeshData &out) const {
+    switch (this->mode) {
+    case MeshingMode::CULLED:
+        this->meshCulled(section, out);
+        break;
+
+    case MeshingMode::GREEDY:
+        this->meshGreedy(section, out);
+        break;
+
+    case MeshingMode::BINARY:
+        this->meshBinary(section, out);
+        break;
+    }
+}
+
+MeshingMode ChunkMesher::getMode() const { return this->mode; }
+
+void ChunkMesher::setMode(MeshingMode mode) { this->mode = mode; }
+
+} // namespace render
+
+} // namespace mine
@@ -0,0 +1,480 @@
+#include "render/ChunkRenderer.hpp"
+#include "opengl/GLState.hpp"
+#include "utils/Profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace mine {
+
+namespace render {
+
+namespace {
+
+// Occluders rasterized per frame, the nearest ones hide the most
+constexpr std::size_t MAX_OCCLUDERS{64};
+
+// Chunks seen as visible are queried again every few frames only, spread
+// over frames by position
+constexpr unsigned int VISIBLE_QUERY_INTERVAL{4};
+
+// Query boxes are grown so a chunk's own faces on its boundary don't hide
+// its box
+constexpr float QUERY_BOX_MARGIN{0.05f};
+
+// Boxes this close to the camera may be cut by the near plane, they are
+// assumed visible
+constexpr float NEAR_MARGIN{1.0f};
+
+glm::vec3 chunkMin(glm::ivec3 position) {
+    return glm::vec3{position * world::Chunk::SIZE};
+}
+
+glm::vec3 chunkMax(glm::ivec3 position) {
+    return chunkMin(position) + static_cast<float>(world::Chunk::SIZE);
+}
+
+} // namespace
+
+ChunkRenderer::ChunkRenderer(jobs::JobSystem &jobSystem)
+    : jobSystem{jobSystem},
+      drawPath{ChunkBufferPool::supportsIndirect()
+                   ? DrawPath::MULTI_DRAW_INDIRECT
+                   : DrawPath::MULTI_DRAW} {}
+
+ChunkRenderer::~ChunkRenderer() { this->jobSystem.wait(this->inFlight); }
+
+void ChunkRenderer::update(world::World &world) {
+    utils::ProfileZone zone{"update"};
+
+    for (auto it = this->meshes.begin(); it != this->meshes.end();) {
+        if (!world.getChunk(it->second.position)) {
+            this->pool.free(it->second.mesh);
+            this->culler.remove(it->second.box);
+            this->releaseQuery(it->second);
+            it = this->meshes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    world.forEachChunk([this, &world](world::Chunk &chunk) {
+        if (!chunk.isDirty() && !this->remeshAll) {
+            return;
+        }
+
+        chunk.clearDirty();
+
+        std::uint64_t key{world::packChunkKey(chunk.getPosition())};
+
+        Entry &entry{this->meshes[key]};
+        entry.position = chunk.getPosition();
+        entry.version = ++this->nextVersion;
+        entry.pending = true;
+
+        // The World isn't thread safe, copy what the mesher needs here
+        auto section{std::make_shared<PaddedSection>(
+            PaddedSection::gather(world, chunk.getPosition()))};
+
+        this->jobSystem.submit(
+            [this, section, key, version = entry.version,
+             mesher = this->mesher]() {
+                utils::ProfileZone zone{"mesh"};
+
+                MeshResult result;
+                result.key = key;
+                result.version = version;
+
+                mesher.mesh(*section, result.data);
+                result.visibility = SectionVisibility::compute(*section);
+                result.occluder = OcclusionCuller::isOccluder(*section);
+
+                this->results.push(std::move(result));
+            },
+            this->inFlight);
+    });
+
+    this->remeshAll = false;
+
+    utils::ProfileZone uploadZone{"upload"};
+
+    using Clock = std::chrono::steady_clock;
+
+    Clock::time_point start{Clock::now()};
+    std::size_t uploadedBytes{0};
+
+    MeshResult result;
+    while (this->results.pop(result)) {
+        auto it{this->meshes.find(result.key)};
+        if (it == this->meshes.end() || it->second.version != result.version) {
+            continue;
+        }
+
+        uploadedBytes += result.data.vertices.size() * sizeof(ChunkVertex) +
+                         result.data.indices.size() * sizeof(unsigned int);
+
+        this->upload(result);
+
+        std::chrono::duration<double, std::milli> elapsed{Clock::now() -
+                                                          start};
+        if (uploadedBytes >= this->uploadBudgetBytes ||
+            elapsed.count() >= this->uploadBudgetMilliseconds) {
+            break;
+        }
+    }
+}
+
+void ChunkRenderer::draw(opengl::ShaderProgram &shaderProgram,
+                         const glm::mat4 &viewProjection,
+                         glm::vec3 cameraPosition) {
+    utils::ProfileZone zone{"draw"};
+
+    shaderProgram.uniform<1>("pageOrigins",
+                             glm::vec<1, int>{ChunkBufferPool::ORIGINS_UNIT});
+
+    Frustum frustum{Frustum::fromMatrix(viewProjection)};
+
+    this->visible.clear();
+    this->culler.cull(frustum, this->visible);
+
+    this->frame++;
+    bool walked{this->visibilityCulling &&
+                this->walkVisibility(frustum, cameraPosition)};
+
+    this->candidates.clear();
+    for (FrustumCuller::Handle box : this->visible) {
+        Entry *entry{this->boxEntries[box]};
+
+        if (!walked || entry->visitedFrame == this->frame) {
+            this->candidates.push_back(entry);
+        }
+    }
+
+    if (this->occlusionMode == OcclusionMode::HARDWARE) {
+        this->drawWithQueries(shaderProgram, cameraPosition);
+    } else {
+        bool occlusion{this->occlusionMode == OcclusionMode::SOFTWARE};
+        if (occlusion) {
+            this->renderOccluders(viewProjection, cameraPosition);
+        }
+
+        this->batch.clear();
+        for (Entry *entry : this->candidates) {
+            if (entry->mesh == ChunkBufferPool::INVALID_HANDLE) {
+                continue;
+            }
+
+            if (occlusion &&
+                !this->occlusionCuller.isVisible(chunkMin(entry->position),
+                                                 chunkMax(entry->position))) {
+                continue;
+            }
+
+            this->batch.push_back(entry->mesh);
+        }
+
+        this->pool.bind();
+        this->pool.draw(this->batch, this->drawPath);
+    }
+
+    opengl::GLState::get().bindVertexArray(0);
+}
+
+std::size_t ChunkRenderer::getMeshCount() const {
+    std::size_t count{0};
+    for (auto &[key, entry] : this->meshes) {
+        count += entry.mesh != ChunkBufferPool::INVALID_HANDLE;
+    }
+
+    return count;
+}
+
+std::size_t ChunkRenderer::getVisibleCount() const {
+    return this->batch.size();
+}
+
+void ChunkRenderer::setVisibilityCulling(bool enabled) {
+    this->visibilityCulling = enabled;
+}
+
+bool ChunkRenderer::getVisibilityCulling() const {
+    return this->visibilityCulling;
+}
+
+void ChunkRenderer::setOcclusionMode(OcclusionMode mode) {
+    this->occlusionMode = mode;
+}
+
+OcclusionMode ChunkRenderer::getOcclusionMode() const {
+    return this->occlusionMode;
+}
+
+void ChunkRenderer::setDrawPath(DrawPath path) { this->drawPath = path; }
+
+DrawPath ChunkRenderer::getDrawPath() const { return this->drawPath; }
+
+void ChunkRenderer::setMeshingMode(MeshingMode mode) {
+    if (mode == this->mesher.getMode()) {
+        return;
+    }
+
+    this->mesher.setMode(mode);
+    this->remeshAll = true;
+}
+
+MeshingMode ChunkRenderer::getMeshingMode() const {
+    return this->mesher.getMode();
+}
+
+void ChunkRenderer::setUploadBudget(std::size_t bytes, double milliseconds) {
+    this->uploadBudgetBytes = bytes;
+    this->uploadBudgetMilliseconds = milliseconds;
+}
+
+std::size_t ChunkRenderer::getPendingCount() const {
+    std::size_t count{0};
+    for (auto &[key, entry] : this->meshes) {
+        count += entry.pending;
+    }
+
+    return count;
+}
+
+void ChunkRenderer::upload(MeshResult &result) {
+    Entry &entry{this->meshes[result.key]};
+    entry.pending = false;
+    entry.visibility = result.visibility;
+    entry.occluder = result.occluder;
+
+    glm::ivec3 origin{entry.position * world::Chunk::SIZE};
+    entry.mesh = this->pool.update(entry.mesh, result.data, origin);
+
+    if (entry.mesh == ChunkBufferPool::INVALID_HANDLE) {
+        this->releaseQuery(entry);
+    }
+
+    // Buried sections have no mesh but still hide what is behind them
+    if (entry.mesh == ChunkBufferPool::INVALID_HANDLE && !entry.occluder) {
+        this->culler.remove(entry.box);
+        entry.box = FrustumCuller::INVALID_HANDLE;
+        return;
+    }
+
+    if (entry.box == FrustumCuller::INVALID_HANDLE) {
+        entry.box = this->culler.add(
+            glm::vec3{origin}, glm::vec3{origin + world::Chunk::SIZE});
+
+        if (entry.box >= this->boxEntries.size()) {
+            this->boxEntries.resize(entry.box + 1);
+        }
+
+        this->boxEntries[entry.box] = &entry;
+    }
+}
+
+bool ChunkRenderer::walkVisibility(const Frustum &frustum,
+                                   glm::vec3 cameraPosition) {
+    // Same order as the faces in SectionVisibility
+    static const glm::ivec3 DIRECTIONS[SectionVisibility::FACE_COUNT]{
+        {-1, 0, 0}, {1, 0, 0}, {0, -1, 0}, {0, 1, 0}, {0, 0, -1}, {0, 0, 1},
+    };
+
+    glm::ivec3 block{glm::floor(cameraPosition)};
+    glm::ivec3 start{world::toChunkCoord(block.x), world::toChunkCoord(block.y),
+                     world::toChunkCoord(block.z)};
+
+    auto it{this->meshes.find(world::packChunkKey(start))};
+    if (it == this->meshes.end()) {
+        return false;
+    }
+
+    it->second.visitedFrame = this->frame;
+
+    this->steps.clear();
+    this->steps.push_back({&it->second, start, -1, 0});
+
+    for (std::size_t i = 0; i < this->steps.size(); i++) {
+        VisibilityStep step{this->steps[i]};
+
+        for (int to = 0; to < SectionVisibility::FACE_COUNT; to++) {
+            // Going back the way we came can't reveal anything new
+            if (step.directions >> SectionVisibility::opposite(to) & 1) {
+                continue;
+            }
+
+            if (step.from >= 0 &&
+                !step.entry->visibility.isConnected(step.from, to)) {
+                continue;
+            }
+
+            glm::ivec3 position{step.position + DIRECTIONS[to]};
+
+            auto next{this->meshes.find(world::packChunkKey(position))};
+            if (next == this->meshes.end() ||
+                next->second.visitedFrame == this->frame) {
+                continue;
+            }
+
+            if (!frustum.intersects(chunkMin(position), chunkMax(position))) {
+                continue;
+            }
+
+            next->second.visitedFrame = this->frame;
+            this->steps.push_back(
+                {&next->second, position, SectionVisibility::opposite(to),
+                 static_cast<std::uint8_t>(step.directions | 1 << to)});
+        }
+    }
+
+    return true;
+}
+
+void ChunkRenderer::renderOccluders(const glm::mat4 &viewProjection,
+                                    glm::vec3 cameraPosition) {
+    this->occluders.clear();
+    for (FrustumCuller::Handle box : this->visible) {
+        if (this->boxEntries[box]->occluder) {
+            this->occluders.push_back(this->boxEntries[box]);
+        }
+    }
+
+    auto distance{[cameraPosition](const Entry *entry) {
+        glm::vec3 center{(chunkMin(entry->position) +
+                          chunkMax(entry->position)) *
+                         0.5f};
+        glm::vec3 offset{center - cameraPosition};
+
+        return glm::dot(offset, offset);
+    }};
+
+    std::size_t count{std::min(this->occluders.size(), MAX_OCCLUDERS)};
+    std::partial_sort(this->occluders.begin(),
+                      this->occluders.begin() + count, this->occluders.end(),
+                      [&distance](const Entry *a, const Entry *b) {
+                          return distance(a) < distance(b);
+                      });
+
+    this->occlusionCuller.begin(viewProjection);
+    for (std::size_t i = 0; i < count; i++) {
+        glm::ivec3 position{this->occluders[i]->position};
+        this->occlusionCuller.addOccluder(chunkMin(position),
+                                          chunkMax(position));
+    }
+
+    this->occlusionCuller.render(this->jobSystem);
+}
+
+void ChunkRenderer::drawWithQueries(opengl::ShaderProgram &shaderProgram,
+                                    glm::vec3 cameraPosition) {
+    if (!this->occlusionQueries) {
+        this->occlusionQueries = std::make_unique<OcclusionQueries>();
+    }
+
+    this->batch.clear();
+    for (Entry *entry : this->candidates) {
+        if (entry->mesh == ChunkBufferPool::INVALID_HANDLE) {
+            continue;
+        }
+
+        bool visible;
+        if (entry->queryPending &&
+            OcclusionQueries::poll(entry->query, visible)) {
+            entry->queryPending = false;
+            entry->occluded = !visible;
+        }
+
+        if (!entry->occluded) {
+            this->batch.push_back(entry->mesh);
+        }
+    }
+
+    // Last frame's visible set fills the depth buffer the queries test
+    // against
+    this->pool.bind();
+    this->pool.draw(this->batch, this->drawPath);
+
+    this->conditional.clear();
+    this->occlusionQueries->begin();
+
+    for (Entry *entry : this->candidates) {
+        if (entry->mesh == ChunkBufferPool::INVALID_HANDLE) {
+            continue;
+        }
+
+        // Still waiting on an earlier query, draw on its result whenever
+        // the GPU gets to it rather than skipping the chunk until then
+        if (entry->queryPending) {
+            if (entry->occluded) {
+                this->conditional.push_back(entry);
+            }
+
+            continue;
+        }
+
+        glm::vec3 min{chunkMin(entry->position) - QUERY_BOX_MARGIN};
+        glm::vec3 max{chunkMax(entry->position) + QUERY_BOX_MARGIN};
+
+        if (glm::all(glm::greaterThan(cameraPosition, min - NEAR_MARGIN)) &&
+            glm::all(glm::lessThan(cameraPosition, max + NEAR_MARGIN))) {
+            if (entry->occluded) {
+                entry->occluded = false;
+                this->conditional.push_back(entry);
+            }
+
+            continue;
+        }
+
+        glm::uvec3 position{entry->position};
+        unsigned int phase{this->frame + position.x + position.y * 3 +
+                           position.z * 5};
+
+        if (!entry->occluded && phase % VISIBLE_QUERY_INTERVAL != 0) {
+            continue;
+        }
+
+        if (!entry->query) {
+            entry->query = this->occlusionQueries->acquire();
+        }
+
+        this->occlusionQueries->query(entry->query, min, max);
+        entry->queryPending = true;
+
+        if (entry->occluded) {
+            this->conditional.push_back(entry);
+        }
+    }
+
+    this->occlusionQueries->end();
+
+    // Chunks hidden last frame may have just come into view, let the GPU
+    // decide from this frame's query instead of popping in a frame late
+    shaderProgram.use();
+    this->pool.bind();
+
+    for (Entry *entry : this->conditional) {
+        bool queried{entry->queryPending};
+        if (queried) {
+            glBeginConditionalRender(entry->query, GL_QUERY_NO_WAIT);
+        }
+
+        this->pool.draw(entry->mesh);
+
+        if (queried) {
+            glEndConditionalRender();
+        }
+    }
+}
+
+void ChunkRenderer::releaseQuery(Entry &entry) {
+    if (this->occlusionQueries) {
+        this->occlusionQueries->release(entry.query);
+    }
+
+    entry.query = 0;
+    entry.queryPending = false;
+    entry.occluded = false;
+}
+
+} // namespace render
+
+} // namespace mine
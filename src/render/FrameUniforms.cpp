@@ -0,0 +1,28 @@
+#include "render/FrameUniforms.hpp"
+
+namespace mine {
+
+namespace render {
+
+FrameUniforms::FrameUniforms() : buffer{GL_UNIFORM_BUFFER} {
+    this->buffer.bufferData(sizeof(FrameData), nullptr, GL_DYNAMIC_DRAW);
+    this->buffer.bindBase(BINDING);
+    this->buffer.unbind();
+}
+
+void FrameUniforms::attach(opengl::ShaderProgram &shaderProgram) {
+    shaderProgram.bindUniformBlock(BLOCK_NAME, BINDING);
+}
+
+void FrameUniforms::update(const FrameData &data) {
+    // Orphan the previous frame's storage so the driver doesn't wait for
+    // draws still reading it
+    this->buffer.bufferData(sizeof(FrameData), nullptr, GL_DYNAMIC_DRAW);
+    this->buffer.bufferSubData(0, sizeof(FrameData), &data);
+    this->buffer.bindBase(BINDING);
+    this->buffer.unbind();
+}
+
+} // namespace render
+
+} // namespace mine
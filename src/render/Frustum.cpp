@@ -0,0 +1,42 @@
+#include "render/Frustum.hpp"
+
+namespace mine {
+
+namespace render {
+
+Frustum Frustum::fromMatrix(const glm::mat4 &viewProjection) {
+    // glm is column major, row i is (m[0][i], m[1][i], m[2][i], m[3][i])
+    auto row{[&viewProjection](int i) {
+        return glm::vec4{viewProjection[0][i], viewProjection[1][i],
+                         viewProjection[2][i], viewProjection[3][i]};
+    }};
+
+    glm::vec4 x{row(0)};
+    glm::vec4 y{row(1)};
+    glm::vec4 z{row(2)};
+    glm::vec4 w{row(3)};
+
+    Frustum frustum;
+    frustum.planes = {w + x, w - x, w + y, w - y, w + z, w - z};
+
+    return frustum;
+}
+
+bool Frustum::intersects(glm::vec3 min, glm::vec3 max) const {
+    for (const auto &plane : this->planes) {
+        // The corner furthest along the plane normal
+        glm::vec3 corner{plane.x > 0.0f ? max.x : min.x,
+                         plane.y > 0.0f ? max.y : min.y,
+                         plane.z > 0.0f ? max.z : min.z};
+
+        if (glm::dot(glm::vec3{plane}, corner) + plane.w < 0.0f) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace render
+
+} // namespace mine
@@ -0,0 +1,169 @@
+#include "render/FrustumCuller.hpp"
+#include "utils/bits.hpp"
+
+#include <cassert>
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <immintrin.h>
+#define MINE_FRUSTUM_SSE
+#endif
+
+namespace mine {
+
+namespace render {
+
+namespace {
+
+/**
+ * Coordinates of the box corner to test against one plane, picked once per
+ * plane rather than per box
+ */
+struct PlaneTest {
+    const float *x;
+    const float *y;
+    const float *z;
+    glm::vec4 plane;
+};
+
+} // namespace
+
+FrustumCuller::Handle FrustumCuller::add(glm::vec3 min, glm::vec3 max) {
+    Handle handle;
+    if (!this->freeHandles.empty()) {
+        handle = this->freeHandles.back();
+        this->freeHandles.pop_back();
+    } else {
+        handle = static_cast<Handle>(this->positions.size());
+        this->positions.emplace_back();
+    }
+
+    this->positions[handle] = static_cast<std::uint32_t>(this->handles.size());
+    this->handles.push_back(handle);
+
+    this->minX.push_back(min.x);
+    this->minY.push_back(min.y);
+    this->minZ.push_back(min.z);
+    this->maxX.push_back(max.x);
+    this->maxY.push_back(max.y);
+    this->maxZ.push_back(max.z);
+
+    return handle;
+}
+
+void FrustumCuller::remove(Handle handle) {
+    if (handle == INVALID_HANDLE) {
+        return;
+    }
+
+    assert(handle < this->positions.size());
+
+    std::uint32_t position{this->positions[handle]};
+    std::uint32_t last{static_cast<std::uint32_t>(this->handles.size() - 1)};
+
+    for (auto *values : {&this->minX, &this->minY, &this->minZ, &this->maxX,
+                         &this->maxY, &this->maxZ}) {
+        (*values)[position] = (*values)[last];
+        values->pop_back();
+    }
+
+    Handle moved{this->handles[last]};
+    this->handles[position] = moved;
+    this->positions[moved] = position;
+    this->handles.pop_back();
+
+    this->freeHandles.push_back(handle);
+}
+
+void FrustumCuller::cull(const Frustum &frustum,
+                         std::vector<Handle> &visible) const {
+    PlaneTest tests[Frustum::PLANE_COUNT];
+    for (int i = 0; i < Frustum::PLANE_COUNT; i++) {
+        const glm::vec4 &plane{frustum.planes[i]};
+
+        tests[i] = {plane.x > 0.0f ? this->maxX.data() : this->minX.data(),
+                    plane.y > 0.0f ? this->maxY.data() : this->minY.data(),
+                    plane.z > 0.0f ? this->maxZ.data() : this->minZ.data(),
+                    plane};
+    }
+
+    std::size_t count{this->handles.size()};
+    std::size_t i{0};
+
+    // Emit the handles of the boxes whose bit is set in `mask`
+    auto emit{[this, &visible](std::size_t first, std::uint32_t mask) {
+        while (mask) {
+            int lane{utils::bits::countTrailingZeros(mask)};
+            visible.push_back(this->handles[first + lane]);
+            mask &= mask - 1;
+        }
+    }};
+
+#if defined(__AVX__)
+    for (; i + 8 <= count; i += 8) {
+        __m256 inside{_mm256_castsi256_ps(_mm256_set1_epi32(-1))};
+
+        for (const auto &test : tests) {
+            __m256 distance{_mm256_set1_ps(test.plane.w)};
+            distance = _mm256_add_ps(
+                distance, _mm256_mul_ps(_mm256_set1_ps(test.plane.x),
+                                        _mm256_loadu_ps(test.x + i)));
+            distance = _mm256_add_ps(
+                distance, _mm256_mul_ps(_mm256_set1_ps(test.plane.y),
+                                        _mm256_loadu_ps(test.y + i)));
+            distance = _mm256_add_ps(
+                distance, _mm256_mul_ps(_mm256_set1_ps(test.plane.z),
+                                        _mm256_loadu_ps(test.z + i)));
+
+            inside = _mm256_and_ps(
+                inside,
+                _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_GE_OQ));
+        }
+
+        emit(i, static_cast<std::uint32_t>(_mm256_movemask_ps(inside)));
+    }
+#endif
+
+#if defined(MINE_FRUSTUM_SSE)
+    for (; i + 4 <= count; i += 4) {
+        __m128 inside{_mm_castsi128_ps(_mm_set1_epi32(-1))};
+
+        for (const auto &test : tests) {
+            __m128 distance{_mm_set1_ps(test.plane.w)};
+            distance = _mm_add_ps(distance,
+                                  _mm_mul_ps(_mm_set1_ps(test.plane.x),
+                                             _mm_loadu_ps(test.x + i)));
+            distance = _mm_add_ps(distance,
+                                  _mm_mul_ps(_mm_set1_ps(test.plane.y),
+                                             _mm_loadu_ps(test.y + i)));
+            distance = _mm_add_ps(distance,
+                                  _mm_mul_ps(_mm_set1_ps(test.plane.z),
+                                             _mm_loadu_ps(test.z + i)));
+
+            inside = _mm_and_ps(inside,
+                                _mm_cmpge_ps(distance, _mm_setzero_ps()));
+        }
+
+        emit(i, static_cast<std::uint32_t>(_mm_movemask_ps(inside)));
+    }
+#endif
+
+    // Whatever doesn't fill a vector, or everything without SIMD
+    for (; i < count; i++) {
+        bool inside{true};
+        for (const auto &test : tests) {
+            float distance{test.plane.x * test.x[i] + test.plane.y * test.y[i] +
+                           test.plane.z * test.z[i] + test.plane.w};
+            inside &= distance >= 0.0f;
+        }
+
+        if (inside) {
+            visible.push_back(this->handles[i]);
+        }
+    }
+}
+
+std::size_t FrustumCuller::size() const { return this->handles.size(); }
+
+} // namespace render
+
+} // namespace mine
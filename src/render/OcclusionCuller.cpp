@@ -0,0 +1,336 @@
+#include "render/OcclusionCuller.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <immintrin.h>
+#define MINE_OCCLUSION_SSE
+#endif
+
+namespace mine {
+
+namespace render {
+
+namespace {
+
+// Rows rasterized by a single job
+constexpr int BAND_ROWS{16};
+
+// Box corners, bit 0 picks max x, bit 1 max y and bit 2 max z
+glm::vec3 corner(glm::vec3 min, glm::vec3 max, int i) {
+    return {i & 1 ? max.x : min.x, i & 2 ? max.y : min.y,
+            i & 4 ? max.z : min.z};
+}
+
+// Corners of each box face, counter-clockwise seen from outside
+constexpr int FACES[6][4]{
+    {0, 4, 6, 2}, {1, 3, 7, 5}, {0, 1, 5, 4},
+    {2, 6, 7, 3}, {0, 2, 3, 1}, {4, 5, 7, 6},
+};
+
+/**
+ * Project a point to the depth buffer, false when it is behind the near
+ * plane
+ */
+bool project(const glm::mat4 &viewProjection, glm::vec3 point,
+             glm::vec3 &out) {
+    glm::vec4 clip{viewProjection * glm::vec4{point, 1.0f}};
+    if (clip.w <= 0.0f || clip.z < -clip.w) {
+        return false;
+    }
+
+    glm::vec3 ndc{glm::vec3{clip} / clip.w};
+    out = {(ndc.x * 0.5f + 0.5f) * OcclusionCuller::WIDTH,
+           (ndc.y * 0.5f + 0.5f) * OcclusionCuller::HEIGHT,
+           ndc.z * 0.5f + 0.5f};
+
+    return true;
+}
+
+/**
+ * Edge function a * x + b * y + c, positive on the inner side of a counter
+ * clockwise edge
+ */
+struct Edge {
+    float a;
+    float b;
+    float c;
+
+    Edge(glm::vec3 from, glm::vec3 to)
+        : a{from.y - to.y}, b{to.x - from.x},
+          c{-(this->a * from.x + this->b * from.y)} {}
+
+    float at(float x, float y) const {
+        return this->a * x + this->b * y + this->c;
+    }
+};
+
+} // namespace
+
+OcclusionCuller::OcclusionCuller() {
+    int width{WIDTH};
+    int height{HEIGHT};
+
+    while (width >= 1 && height >= 1) {
+        this->levels.push_back(
+            {width, height, std::vector<float>(width * height, 1.0f)});
+
+        width /= 2;
+        height /= 2;
+    }
+}
+
+bool OcclusionCuller::isOccluder(const PaddedSection &section) {
+    if (section.isEmpty()) {
+        return false;
+    }
+
+    constexpr int LAST{world::Chunk::SIZE - 1};
+
+    for (int y = 0; y <= LAST; y++) {
+        for (int z = 0; z <= LAST; z++) {
+            bool inner{y > 0 && y < LAST && z > 0 && z < LAST};
+
+            // Inner rows only have their two ends on the boundary
+            int step{inner ? LAST : 1};
+            for (int x = 0; x <= LAST; x += step) {
+                if (world::isTransparent(section.get(x, y, z))) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+void OcclusionCuller::begin(const glm::mat4 &viewProjection) {
+    this->viewProjection = viewProjection;
+    this->triangles.clear();
+    this->occluderCount = 0;
+}
+
+void OcclusionCuller::addOccluder(glm::vec3 min, glm::vec3 max) {
+    glm::vec3 screen[8];
+    for (int i = 0; i < 8; i++) {
+        if (!project(this->viewProjection, corner(min, max, i), screen[i])) {
+            return;
+        }
+    }
+
+    for (const auto &face : FACES) {
+        glm::vec3 a{screen[face[0]]};
+        glm::vec3 b{screen[face[1]]};
+        glm::vec3 c{screen[face[2]]};
+        glm::vec3 d{screen[face[3]]};
+
+        // Back faces are always behind a front face of the same box
+        float area{(b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x)};
+        if (area <= 0.0f) {
+            continue;
+        }
+
+        this->triangles.push_back({{a, b, c}});
+        this->triangles.push_back({{a, c, d}});
+    }
+
+    this->occluderCount++;
+}
+
+void OcclusionCuller::render(jobs::JobSystem &jobSystem) {
+    int bands{(HEIGHT + BAND_ROWS - 1) / BAND_ROWS};
+
+    jobSystem.parallelFor(
+        static_cast<std::size_t>(bands), [this](std::size_t band) {
+            int firstRow{static_cast<int>(band) * BAND_ROWS};
+            int lastRow{std::min(firstRow + BAND_ROWS, HEIGHT) - 1};
+
+            std::fill(this->levels[0].depth.begin() + firstRow * WIDTH,
+                      this->levels[0].depth.begin() + (lastRow + 1) * WIDTH,
+                      1.0f);
+
+            for (const auto &triangle : this->triangles) {
+                this->rasterize(triangle, firstRow, lastRow);
+            }
+        });
+
+    this->buildHierarchy();
+}
+
+bool OcclusionCuller::isVisible(glm::vec3 min, glm::vec3 max) const {
+    glm::vec3 lower{static_cast<float>(WIDTH), static_cast<float>(HEIGHT),
+                    1.0f};
+    glm::vec3 upper{0.0f};
+
+    for (int i = 0; i < 8; i++) {
+        glm::vec3 screen;
+        if (!project(this->viewProjection, corner(min, max, i), screen)) {
+            return true;
+        }
+
+        lower = glm::min(lower, screen);
+        upper = glm::max(upper, screen);
+    }
+
+    // Occluders cover whole pixels whose center they cover, grow the box by
+    // a pixel so a sliver seen past their edge still counts
+    int x0{std::max(static_cast<int>(std::floor(lower.x)) - 1, 0)};
+    int y0{std::max(static_cast<int>(std::floor(lower.y)) - 1, 0)};
+    int x1{std::min(static_cast<int>(std::floor(upper.x)) + 1, WIDTH - 1)};
+    int y1{std::min(static_cast<int>(std::floor(upper.y)) + 1, HEIGHT - 1)};
+
+    if (x0 > x1 || y0 > y1) {
+        return false;
+    }
+
+    // Coarsest level where the box covers at most 4x4 texels
+    std::size_t level{0};
+    while (level + 1 < this->levels.size() &&
+           ((x1 >> level) - (x0 >> level) > 3 ||
+            (y1 >> level) - (y0 >> level) > 3)) {
+        level++;
+    }
+
+    const Level &depth{this->levels[level]};
+
+    float farthest{0.0f};
+    for (int y = y0 >> level; y <= std::min(y1 >> level, depth.height - 1);
+         y++) {
+        for (int x = x0 >> level; x <= std::min(x1 >> level, depth.width - 1);
+             x++) {
+            farthest = std::max(farthest, depth.depth[y * depth.width + x]);
+        }
+    }
+
+    return lower.z <= farthest;
+}
+
+std::size_t OcclusionCuller::getOccluderCount() const {
+    return this->occluderCount;
+}
+
+const std::vector<float> &OcclusionCuller::getDepth() const {
+    return this->levels[0].depth;
+}
+
+void OcclusionCuller::rasterize(const Triangle &triangle, int firstRow,
+                                int lastRow) {
+    const glm::vec3 &v0{triangle.vertices[0]};
+    const glm::vec3 &v1{triangle.vertices[1]};
+    const glm::vec3 &v2{triangle.vertices[2]};
+
+    float minX{std::min({v0.x, v1.x, v2.x})};
+    float maxX{std::max({v0.x, v1.x, v2.x})};
+    float minY{std::min({v0.y, v1.y, v2.y})};
+    float maxY{std::max({v0.y, v1.y, v2.y})};
+
+    int x0{std::max(static_cast<int>(std::floor(minX)), 0)};
+    int x1{std::min(static_cast<int>(std::ceil(maxX)), WIDTH - 1)};
+    int y0{std::max(static_cast<int>(std::floor(minY)), firstRow)};
+    int y1{std::min(static_cast<int>(std::ceil(maxY)), lastRow)};
+
+    if (x0 > x1 || y0 > y1) {
+        return;
+    }
+
+    // Each edge is named after the vertex opposite to it
+    Edge e0{v1, v2};
+    Edge e1{v2, v0};
+    Edge e2{v0, v1};
+
+    float area{e2.at(v2.x, v2.y)};
+    if (area <= 0.0f) {
+        return;
+    }
+
+    // Depth is affine in screen space, z = dzdx * x + dzdy * y + z0
+    float dzdx{(e0.a * v0.z + e1.a * v1.z + e2.a * v2.z) / area};
+    float dzdy{(e0.b * v0.z + e1.b * v1.z + e2.b * v2.z) / area};
+    float z0{(e0.c * v0.z + e1.c * v1.z + e2.c * v2.z) / area};
+
+    std::vector<float> &depth{this->levels[0].depth};
+
+#if defined(MINE_OCCLUSION_SSE)
+    // Whole groups of four pixels, WIDTH is a multiple of four
+    x0 &= ~3;
+
+    __m128 offsets{_mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f)};
+    __m128 zero{_mm_setzero_ps()};
+
+    for (int y = y0; y <= y1; y++) {
+        float centerY{static_cast<float>(y) + 0.5f};
+
+        __m128 xs{_mm_add_ps(_mm_set1_ps(static_cast<float>(x0)), offsets)};
+        __m128 four{_mm_set1_ps(4.0f)};
+
+        for (int x = x0; x <= x1; x += 4) {
+            __m128 w0{_mm_add_ps(_mm_mul_ps(_mm_set1_ps(e0.a), xs),
+                                 _mm_set1_ps(e0.b * centerY + e0.c))};
+            __m128 w1{_mm_add_ps(_mm_mul_ps(_mm_set1_ps(e1.a), xs),
+                                 _mm_set1_ps(e1.b * centerY + e1.c))};
+            __m128 w2{_mm_add_ps(_mm_mul_ps(_mm_set1_ps(e2.a), xs),
+                                 _mm_set1_ps(e2.b * centerY + e2.c))};
+
+            __m128 inside{_mm_and_ps(
+                _mm_and_ps(_mm_cmpge_ps(w0, zero), _mm_cmpge_ps(w1, zero)),
+                _mm_cmpge_ps(w2, zero))};
+
+            if (_mm_movemask_ps(inside)) {
+                __m128 z{_mm_add_ps(_mm_mul_ps(_mm_set1_ps(dzdx), xs),
+                                    _mm_set1_ps(dzdy * centerY + z0))};
+
+                float *row{depth.data() + y * WIDTH + x};
+                __m128 stored{_mm_loadu_ps(row)};
+                __m128 nearest{_mm_min_ps(stored, z)};
+
+                _mm_storeu_ps(row,
+                              _mm_or_ps(_mm_and_ps(inside, nearest),
+                                        _mm_andnot_ps(inside, stored)));
+            }
+
+            xs = _mm_add_ps(xs, four);
+        }
+    }
+#else
+    for (int y = y0; y <= y1; y++) {
+        float centerY{static_cast<float>(y) + 0.5f};
+
+        for (int x = x0; x <= x1; x++) {
+            float centerX{static_cast<float>(x) + 0.5f};
+
+            if (e0.at(centerX, centerY) < 0.0f ||
+                e1.at(centerX, centerY) < 0.0f ||
+                e2.at(centerX, centerY) < 0.0f) {
+                continue;
+            }
+
+            float z{dzdx * centerX + dzdy * centerY + z0};
+            float &stored{depth[y * WIDTH + x]};
+            stored = std::min(stored, z);
+        }
+    }
+#endif
+}
+
+void OcclusionCuller::buildHierarchy() {
+    for (std::size_t i = 1; i < this->levels.size(); i++) {
+        const Level &source{this->levels[i - 1]};
+        Level &target{this->levels[i]};
+
+        for (int y = 0; y < target.height; y++) {
+            const float *row0{source.depth.data() + 2 * y * source.width};
+            const float *row1{row0 + source.width};
+
+            for (int x = 0; x < target.width; x++) {
+                target.depth[y * target.width + x] =
+                    std::max(std::max(row0[2 * x], row0[2 * x + 1]),
+                             std::max(row1[2 * x], row1[2 * x + 1]));
+            }
+        }
+    }
+}
+
+} // namespace render
+
+} // namespace mine
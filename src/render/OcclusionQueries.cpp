@@ -0,0 +1,129 @@
+#include "render/OcclusionQueries.hpp"
+#include "render/FrameUniforms.hpp"
+
+#include <cassert>
+#include <cstdint>
+
+namespace mine {
+
+namespace render {
+
+namespace {
+
+// Unit cube corners, bit 0 is x, bit 1 is y and bit 2 is z
+constexpr std::uint8_t CUBE_VERTICES[8][3]{
+    {0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {1, 1, 0},
+    {0, 0, 1}, {1, 0, 1}, {0, 1, 1}, {1, 1, 1},
+};
+
+constexpr std::uint8_t CUBE_INDICES[36]{
+    0, 4, 6, 0, 6, 2, // -X
+    1, 3, 7, 1, 7, 5, // +X
+    0, 1, 5, 0, 5, 4, // -Y
+    2, 6, 7, 2, 7, 3, // +Y
+    0, 2, 3, 0, 3, 1, // -Z
+    4, 5, 7, 4, 7, 6, // +Z
+};
+
+} // namespace
+
+OcclusionQueries::OcclusionQueries()
+    : program{opengl::ShaderProgram::fromFiles(
+          "shaders/occlusion_vertex.glsl", "shaders/occlusion_fragment.glsl")},
+      cube{[](opengl::VertexArray &vao) {
+          auto &vbo{vao.addBuffer()};
+          auto &ebo{vao.addBuffer(GL_ELEMENT_ARRAY_BUFFER)};
+
+          vbo.bufferData(sizeof(CUBE_VERTICES), CUBE_VERTICES,
+                         GL_STATIC_DRAW);
+          ebo.bufferData(sizeof(CUBE_INDICES), CUBE_INDICES, GL_STATIC_DRAW);
+
+          vao.vertexAttribPointer(0, 3, GL_UNSIGNED_BYTE, false,
+                                  sizeof(CUBE_VERTICES[0]), nullptr);
+      }} {
+    this->program.bindUniformBlock(FrameUniforms::BLOCK_NAME,
+                                   FrameUniforms::BINDING);
+
+    this->boxMin = this->program.getUniform("boxMin");
+    this->boxSize = this->program.getUniform("boxSize");
+}
+
+OcclusionQueries::~OcclusionQueries() {
+    if (!this->queries.empty()) {
+        glDeleteQueries(static_cast<GLsizei>(this->queries.size()),
+                        this->queries.data());
+    }
+}
+
+GLuint OcclusionQueries::acquire() {
+    if (!this->freeQueries.empty()) {
+        GLuint query{this->freeQueries.back()};
+        this->freeQueries.pop_back();
+        return query;
+    }
+
+    GLuint query;
+    glGenQueries(1, &query);
+    this->queries.push_back(query);
+
+    return query;
+}
+
+void OcclusionQueries::release(GLuint query) {
+    if (query) {
+        this->freeQueries.push_back(query);
+    }
+}
+
+void OcclusionQueries::begin() {
+    this->cullFace = glIsEnabled(GL_CULL_FACE);
+
+    // The camera can be close enough for the near plane to cut a box,
+    // back faces still give an answer then
+    glDisable(GL_CULL_FACE);
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glDepthMask(GL_FALSE);
+
+    this->program.use();
+    this->cube.bind();
+}
+
+void OcclusionQueries::query(GLuint query, glm::vec3 min, glm::vec3 max) {
+    assert(query);
+
+    this->program.uniform<3>(this->boxMin, min);
+    this->program.uniform<3>(this->boxSize, max - min);
+
+    glBeginQuery(GL_ANY_SAMPLES_PASSED, query);
+    glDrawElements(GL_TRIANGLES, sizeof(CUBE_INDICES), GL_UNSIGNED_BYTE,
+                   nullptr);
+    glEndQuery(GL_ANY_SAMPLES_PASSED);
+}
+
+void OcclusionQueries::end() {
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glDepthMask(GL_TRUE);
+
+    if (this->cullFace) {
+        glEnable(GL_CULL_FACE);
+    }
+}
+
+bool OcclusionQueries::poll(GLuint query, bool &visible) {
+    GLuint available{GL_FALSE};
+    glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+
+    if (!available) {
+        return false;
+    }
+
+    GLuint result{GL_FALSE};
+    glGetQueryObjectuiv(query, GL_QUERY_RESULT, &result);
+    visible = result != GL_FALSE;
+
+    return true;
+}
+
+} // namespace render
+
+} // namespace mine
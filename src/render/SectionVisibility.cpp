@@ -0,0 +1,122 @@
+#include "render/SectionVisibility.hpp"
+
+#include <bitset>
+
+namespace mine {
+
+namespace render {
+
+namespace {
+
+constexpr int SIZE{world::Chunk::SIZE};
+constexpr int VOLUME{SIZE * SIZE * SIZE};
+
+int index(int x, int y, int z) { return (y * SIZE + z) * SIZE + x; }
+
+/**
+ * Mask of the section faces a block touches
+ */
+std::uint8_t touchedFaces(int x, int y, int z) {
+    std::uint8_t faces{0};
+    faces |= (x == 0) << 0;
+    faces |= (x == SIZE - 1) << 1;
+    faces |= (y == 0) << 2;
+    faces |= (y == SIZE - 1) << 3;
+    faces |= (z == 0) << 4;
+    faces |= (z == SIZE - 1) << 5;
+
+    return faces;
+}
+
+} // namespace
+
+SectionVisibility SectionVisibility::all() {
+    SectionVisibility visibility;
+    visibility.bits = (std::uint64_t{1} << (FACE_COUNT * FACE_COUNT)) - 1;
+
+    return visibility;
+}
+
+SectionVisibility SectionVisibility::compute(const PaddedSection &section) {
+    if (section.isEmpty()) {
+        return all();
+    }
+
+    SectionVisibility visibility;
+
+    // Solid blocks start out visited so the fill never enters them
+    std::bitset<VOLUME> visited;
+    for (int y = 0; y < SIZE; y++) {
+        for (int z = 0; z < SIZE; z++) {
+            for (int x = 0; x < SIZE; x++) {
+                if (!world::isTransparent(section.get(x, y, z))) {
+                    visited.set(index(x, y, z));
+                }
+            }
+        }
+    }
+
+    std::vector<std::uint16_t> stack;
+    stack.reserve(VOLUME);
+
+    // Pockets that matter touch the boundary, so only start from there
+    for (int start = 0; start < VOLUME; start++) {
+        int startX{start % SIZE};
+        int startY{start / (SIZE * SIZE)};
+        int startZ{(start / SIZE) % SIZE};
+
+        if (visited.test(start) || !touchedFaces(startX, startY, startZ)) {
+            continue;
+        }
+
+        std::uint8_t faces{0};
+
+        visited.set(start);
+        stack.push_back(static_cast<std::uint16_t>(start));
+
+        while (!stack.empty()) {
+            int current{stack.back()};
+            stack.pop_back();
+
+            int x{current % SIZE};
+            int y{current / (SIZE * SIZE)};
+            int z{(current / SIZE) % SIZE};
+
+            faces |= touchedFaces(x, y, z);
+
+            auto visit{[&](int nx, int ny, int nz) {
+                if (nx < 0 || ny < 0 || nz < 0 || nx >= SIZE || ny >= SIZE ||
+                    nz >= SIZE) {
+                    return;
+                }
+
+                int neighbour{index(nx, ny, nz)};
+                if (!visited.test(neighbour)) {
+                    visited.set(neighbour);
+                    stack.push_back(static_cast<std::uint16_t>(neighbour));
+                }
+            }};
+
+            visit(x - 1, y, z);
+            visit(x + 1, y, z);
+            visit(x, y - 1, z);
+            visit(x, y + 1, z);
+            visit(x, y, z - 1);
+            visit(x, y, z + 1);
+        }
+
+        for (int from = 0; from < FACE_COUNT; from++) {
+            for (int to = from; to < FACE_COUNT; to++) {
+                if ((faces >> from & 1) && (faces >> to & 1)) {
+                    visibility.connect(from, to);
+                }
+            }
+        }
+    }
+
+    return visibility;
+}
+
+} // namespace render
+
+} // namespace mine
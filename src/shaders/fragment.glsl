@@ -1,9 +1,40 @@
 #version 330 core
 
-uniform vec4 color;
+#include "frame.glsl"
+
+// Fog covers the scene between these fractions of the far plane, and
+// matches the clear color so distant terrain fades into the sky
+#ifndef FOG_START
+#define FOG_START 0.2
+#endif
+
+#ifndef FOG_END
+#define FOG_END 0.6
+#endif
+
+const vec3 FOG_COLOR = vec3(0.2, 0.3, 0.9);
+
+// Block textures, a layer each, see render::BlockTextures
+uniform sampler2DArray blockTextures;
+
+in float shade;
+in vec3 texCoord;
+
+#ifdef FOG
+in float viewDistance;
+#endif
 
 out vec4 FragColor;
 
 void main() {
-    FragColor = vec4(color);
+    vec4 color = texture(blockTextures, texCoord);
+    vec3 rgb = color.rgb * shade;
+
+#ifdef FOG
+    float far = parameters.z;
+    rgb = mix(rgb, FOG_COLOR,
+              smoothstep(FOG_START * far, FOG_END * far, viewDistance));
+#endif
+
+    FragColor = vec4(rgb, color.a);
 }
@@ -0,0 +1,8 @@
+// Shared by every program, see render::FrameData
+layout (std140) uniform Frame {
+    mat4 viewProjection;
+    mat4 view;
+    mat4 projection;
+    vec4 cameraPosition;
+    vec4 parameters;
+};
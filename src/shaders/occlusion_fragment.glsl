@@ -0,0 +1,8 @@
+#version 330 core
+
+out vec4 FragColor;
+
+// Color writes are masked while querying, only the depth test matters
+void main() {
+    FragColor = vec4(1.0);
+}
@@ -0,0 +1,13 @@
+#version 330 core
+
+// Corner of a unit cube, see render::OcclusionQueries
+layout (location = 0) in vec3 aPosition;
+
+#include "frame.glsl"
+
+uniform vec3 boxMin;
+uniform vec3 boxSize;
+
+void main() {
+    gl_Position = viewProjection * vec4(boxMin + aPosition * boxSize, 1.0);
+}
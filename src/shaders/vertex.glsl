@@ -1,11 +1,55 @@
 #version 330 core
 
-layout (location = 0) in vec3 aPos;
+// Packed chunk vertex, see render::ChunkVertex
+layout (location = 0) in uint aData;
 
-uniform vec3 offset;
+#include "frame.glsl"
 
-uniform mat4 mvp;
+// World origin of the chunk owning each page of 64 vertices, see
+// render::ChunkBufferPool. gl_VertexID includes the base vertex.
+uniform isamplerBuffer pageOrigins;
+
+out float shade;
+out vec3 texCoord;
+
+#ifdef FOG
+out float viewDistance;
+#endif
+
+// Indexed by the face normal, in the order of the mesher's face table:
+// -X, +X, -Y, +Y, -Z, +Z
+const float FACE_SHADE[6] = float[6](0.7, 0.7, 0.5, 1.0, 0.8, 0.8);
 
 void main() {
-    gl_Position = mvp * vec4(aPos + offset, 1.0);
+    vec3 position = vec3(float(aData & 31u), float((aData >> 5u) & 31u),
+                         float((aData >> 10u) & 31u));
+
+    uint normal = (aData >> 15u) & 7u;
+    float layer = float(aData >> 24u);
+    float light = float((aData >> 20u) & 15u) / 15.0;
+
+    vec3 origin = vec3(texelFetch(pageOrigins, gl_VertexID >> 6).xyz);
+
+    // Textures repeat once per block along the face, with v going down
+    // the sides like the images
+    uint axis = normal >> 1u;
+    vec2 uv = axis == 0u ? vec2(position.z, 1.0 - position.y)
+            : axis == 1u ? position.xz
+                         : vec2(position.x, 1.0 - position.y);
+
+    texCoord = vec3(uv, layer);
+    shade = FACE_SHADE[normal] * light;
+
+#ifdef AMBIENT_OCCLUSION
+    float ao = float((aData >> 18u) & 3u) / 3.0;
+    shade *= mix(0.5, 1.0, ao);
+#endif
+
+    vec3 worldPosition = position + origin;
+
+#ifdef FOG
+    viewDistance = distance(worldPosition, cameraPosition.xyz);
+#endif
+
+    gl_Position = viewProjection * vec4(worldPosition, 1.0);
 }
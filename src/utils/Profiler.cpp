@@ -0,0 +1,187 @@
+#include "utils/Profiler.hpp"
+
+#include <chrono>
+#include <cstdio>
+
+namespace mine {
+
+namespace utils {
+
+namespace {
+
+// A seqlock per slot, so a trace can be written while the owning thread
+// overwrites zones. The sequence is odd while a write is in progress.
+struct Zone {
+    std::atomic<std::uint64_t> sequence{0};
+    std::atomic<const char *> name{nullptr};
+    std::atomic<std::uint64_t> start{0};
+    std::atomic<std::uint64_t> end{0};
+};
+
+thread_local std::string threadName;
+
+std::int64_t steadyNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+} // namespace
+
+struct Profiler::Track {
+    int id;
+    std::string name;
+
+    // Total zones ever written, the ring index is this modulo CAPACITY
+    std::atomic<std::uint64_t> written{0};
+    std::unique_ptr<Zone[]> zones{new Zone[CAPACITY]};
+};
+
+thread_local Profiler::Track *Profiler::current{nullptr};
+
+Profiler &Profiler::get() {
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::Profiler() : epoch{steadyNanoseconds()} {}
+
+void Profiler::setEnabled(bool enabled) {
+    this->enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Profiler::isEnabled() const {
+    return this->enabled.load(std::memory_order_relaxed);
+}
+
+void Profiler::setThreadName(std::string name) {
+    threadName = std::move(name);
+
+    if (current) {
+        std::lock_guard<std::mutex> lock{this->mutex};
+        current->name = threadName;
+    }
+}
+
+std::uint64_t Profiler::now() const {
+    return static_cast<std::uint64_t>(steadyNanoseconds() - this->epoch);
+}
+
+void Profiler::record(const char *name, std::uint64_t start,
+                      std::uint64_t end) {
+    this->record(this->threadTrack(), name, start, end);
+}
+
+Profiler::Track &Profiler::addTrack(std::string name) {
+    auto track{std::make_unique<Track>()};
+    track->name = std::move(name);
+
+    std::lock_guard<std::mutex> lock{this->mutex};
+    track->id = static_cast<int>(this->tracks.size());
+    this->tracks.push_back(std::move(track));
+
+    return *this->tracks.back();
+}
+
+void Profiler::record(Track &track, const char *name, std::uint64_t start,
+                      std::uint64_t end) {
+    // Only one thread writes to a track
+    std::uint64_t index{track.written.load(std::memory_order_relaxed)};
+    Zone &zone{track.zones[index % CAPACITY]};
+
+    zone.sequence.store(index * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    zone.name.store(name, std::memory_order_relaxed);
+    zone.start.store(start, std::memory_order_relaxed);
+    zone.end.store(end, std::memory_order_relaxed);
+
+    zone.sequence.store(index * 2 + 2, std::memory_order_release);
+    track.written.store(index + 1, std::memory_order_release);
+}
+
+bool Profiler::writeChromeTrace(const char *path) {
+    std::FILE *file{std::fopen(path, "w")};
+    if (!file) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock{this->mutex};
+
+    std::fprintf(file, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+
+    bool first{true};
+    for (const auto &track : this->tracks) {
+        std::fprintf(file,
+                     "%s{\"name\": \"thread_name\", \"ph\": \"M\", "
+                     "\"pid\": 1, \"tid\": %d, \"args\": {\"name\": \"%s\"}}",
+                     first ? "" : ",\n", track->id, track->name.c_str());
+        first = false;
+
+        std::uint64_t written{track->written.load(std::memory_order_acquire)};
+        std::uint64_t oldest{written > CAPACITY ? written - CAPACITY : 0};
+
+        for (std::uint64_t index = oldest; index < written; index++) {
+            const Zone &zone{track->zones[index % CAPACITY]};
+
+            std::uint64_t sequence{
+                zone.sequence.load(std::memory_order_acquire)};
+            const char *name{zone.name.load(std::memory_order_relaxed)};
+            std::uint64_t start{zone.start.load(std::memory_order_relaxed)};
+            std::uint64_t end{zone.end.load(std::memory_order_relaxed)};
+
+            // Skip zones the thread overwrote while we were reading them
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence != index * 2 + 2 ||
+                zone.sequence.load(std::memory_order_relaxed) != sequence) {
+                continue;
+            }
+
+            // Chrome wants microseconds, the fraction keeps the nanoseconds
+            std::fprintf(file,
+                         ",\n{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, "
+                         "\"tid\": %d, \"ts\": %.3f, \"dur\": %.3f}",
+                         name, track->id, static_cast<double>(start) / 1000.0,
+                         static_cast<double>(end - start) / 1000.0);
+        }
+    }
+
+    std::fprintf(file, "\n]}\n");
+
+    return std::fclose(file) == 0;
+}
+
+Profiler::Track &Profiler::threadTrack() {
+    if (!current) {
+        auto track{std::make_unique<Track>()};
+
+        std::lock_guard<std::mutex> lock{this->mutex};
+        track->id = static_cast<int>(this->tracks.size());
+        track->name = threadName.empty()
+                          ? "Thread " + std::to_string(track->id)
+                          : threadName;
+
+        current = track.get();
+        this->tracks.push_back(std::move(track));
+    }
+
+    return *current;
+}
+
+ProfileZone::ProfileZone(const char *name)
+    : name{name}, start{0}, active{Profiler::get().isEnabled()} {
+    if (this->active) {
+        this->start = Profiler::get().now();
+    }
+}
+
+ProfileZone::~ProfileZone() {
+    if (this->active) {
+        Profiler &profiler{Profiler::get()};
+        profiler.record(this->name, this->start, profiler.now());
+    }
+}
+
+} // namespace utils
+
+} // namespace mine
@@ -0,0 +1,103 @@
+#include "utils/RangeAllocator.hpp"
+
+#include <cassert>
+#include <iterator>
+
+namespace mine {
+
+namespace utils {
+
+RangeAllocator::RangeAllocator(std::size_t capacity) : capacity{0} {
+    this->reset(capacity);
+}
+
+std::optional<std::size_t> RangeAllocator::allocate(std::size_t size) {
+    assert(size > 0);
+
+    auto it{this->bySize.lower_bound({size, 0})};
+    if (it == this->bySize.end()) {
+        return std::nullopt;
+    }
+
+    auto [blockSize, offset]{*it};
+
+    this->eraseFree(this->byOffset.find(offset));
+
+    if (blockSize > size) {
+        this->insertFree(offset + size, blockSize - size);
+    }
+
+    this->used += size;
+
+    return offset;
+}
+
+void RangeAllocator::free(std::size_t offset, std::size_t size) {
+    assert(size > 0 && offset + size <= this->capacity);
+    assert(this->used >= size);
+
+    this->used -= size;
+
+    auto next{this->byOffset.find(offset + size)};
+    if (next != this->byOffset.end()) {
+        size += next->second;
+        this->eraseFree(next);
+    }
+
+    auto after{this->byOffset.lower_bound(offset)};
+    if (after != this->byOffset.begin()) {
+        auto previous{std::prev(after)};
+        if (previous->first + previous->second == offset) {
+            offset = previous->first;
+            size += previous->second;
+            this->eraseFree(previous);
+        }
+    }
+
+    this->insertFree(offset, size);
+}
+
+void RangeAllocator::reset(std::size_t capacity) {
+    this->capacity = capacity;
+    this->used = 0;
+
+    this->byOffset.clear();
+    this->bySize.clear();
+
+    if (capacity > 0) {
+        this->insertFree(0, capacity);
+    }
+}
+
+std::size_t RangeAllocator::getCapacity() const { return this->capacity; }
+
+std::size_t RangeAllocator::getUsed() const { return this->used; }
+
+std::size_t RangeAllocator::getLargestFree() const {
+    return this->bySize.empty() ? 0 : this->bySize.rbegin()->first;
+}
+
+float RangeAllocator::getFragmentation() const {
+    std::size_t free{this->capacity - this->used};
+    if (free == 0) {
+        return 0.0f;
+    }
+
+    return 1.0f - static_cast<float>(this->getLargestFree()) /
+                      static_cast<float>(free);
+}
+
+void RangeAllocator::insertFree(std::size_t offset, std::size_t size) {
+    this->byOffset.emplace(offset, size);
+    this->bySize.emplace(size, offset);
+}
+
+void RangeAllocator::eraseFree(
+    std::map<std::size_t, std::size_t>::iterator it) {
+    this->bySize.erase({it->second, it->first});
+    this->byOffset.erase(it);
+}
+
+} // namespace utils
+
+} // namespace mine
@@ -1,5 +1,6 @@
 #include "utils/fs.hpp"
 
+#include <cstdio>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -28,6 +29,43 @@ std::string readFile(const char *path) {
 
     return ss.str();
 }
+
+bool readBinaryFile(const char *path, std::vector<unsigned char> &out) {
+    std::ifstream file{path, std::ios::binary | std::ios::ate};
+    if (file.fail()) {
+        return false;
+    }
+
+    std::streamsize size{file.tellg()};
+    file.seekg(0);
+
+    std::vector<unsigned char> contents(static_cast<std::size_t>(size));
+    if (!file.read(reinterpret_cast<char *>(contents.data()), size)) {
+        return false;
+    }
+
+    out = std::move(contents);
+    return true;
+}
+
+bool writeBinaryFile(const char *path, const void *data, std::size_t size) {
+    std::string temporary{std::string{path} + ".tmp"};
+
+    {
+        std::ofstream file{temporary, std::ios::binary | std::ios::trunc};
+        if (file.fail()) {
+            return false;
+        }
+
+        file.write(static_cast<const char *>(data),
+                   static_cast<std::streamsize>(size));
+        if (!file) {
+            return false;
+        }
+    }
+
+    return std::rename(temporary.c_str(), path) == 0;
+}
 } // namespace fs
 } // namespace utils
 } // namespace mine
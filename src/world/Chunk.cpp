@@ -0,0 +1,32 @@
+#include "world/Chunk.hpp"
+
+namespace mine {
+
+namespace world {
+
+Chunk::Chunk(glm::ivec3 position, BlockId fill)
+    : position{position}, section{fill} {}
+
+void Chunk::setBlock(int x, int y, int z, BlockId block) {
+    if (this->section.getBlock(x, y, z) == block) {
+        return;
+    }
+
+    this->section.setBlock(x, y, z, block);
+    this->dirty = true;
+}
+
+glm::ivec3 Chunk::getPosition() const { return this->position; }
+
+glm::ivec3 Chunk::getOrigin() const { return this->position * SIZE; }
+
+ChunkSection &Chunk::getSection() { return this->section; }
+const ChunkSection &Chunk::getSection() const { return this->section; }
+
+bool Chunk::isDirty() const { return this->dirty; }
+void Chunk::markDirty() { this->dirty = true; }
+void Chunk::clearDirty() { this->dirty = false; }
+
+} // namespace world
+
+} // namespace mine
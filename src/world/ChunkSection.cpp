@@ -0,0 +1,167 @@
+#include "world/ChunkSection.hpp"
+
+#include <algorithm>
+
+namespace mine {
+
+namespace world {
+
+namespace {
+
+/**
+ * Smallest supported index width able to address `paletteSize` entries
+ */
+int bitsFor(std::size_t paletteSize) {
+    int bits{1};
+    while ((std::size_t{1} << bits) < paletteSize) {
+        bits <<= 1;
+    }
+
+    return bits;
+}
+
+int log2(int value) {
+    int result{0};
+    while (value > 1) {
+        value >>= 1;
+        result++;
+    }
+
+    return result;
+}
+
+} // namespace
+
+ChunkSection::ChunkSection(BlockId fill) { this->fill(fill); }
+
+void ChunkSection::setBlock(int x, int y, int z, BlockId block) {
+    assert(inBounds(x, y, z));
+
+    BlockId previous{this->getBlock(x, y, z)};
+    if (previous == block) {
+        return;
+    }
+
+    if (previous == blocks::AIR) {
+        this->nonAirCount++;
+    } else if (block == blocks::AIR) {
+        this->nonAirCount--;
+    }
+
+    unsigned int paletteIndex{this->findOrAddPalette(block)};
+    this->setIndex(blockIndex(x, y, z), paletteIndex);
+}
+
+void ChunkSection::fill(BlockId block) {
+    this->palette.assign(1, block);
+    this->data.clear();
+    this->data.shrink_to_fit();
+
+    this->bits = 0;
+    this->bitsShift = 0;
+    this->wordShift = 0;
+    this->mask = 0;
+
+    this->nonAirCount = block == blocks::AIR ? 0 : VOLUME;
+}
+
+void ChunkSection::compact() {
+    if (this->bits == 0) {
+        return;
+    }
+
+    std::vector<int> usage(this->palette.size(), 0);
+    for (int i = 0; i < VOLUME; i++) {
+        usage[this->getIndex(i)]++;
+    }
+
+    std::vector<unsigned int> remap(this->palette.size(), 0);
+    std::vector<BlockId> newPalette;
+
+    for (std::size_t i = 0; i < this->palette.size(); i++) {
+        if (usage[i] > 0) {
+            remap[i] = static_cast<unsigned int>(newPalette.size());
+            newPalette.push_back(this->palette[i]);
+        }
+    }
+
+    if (newPalette.size() == 1) {
+        this->fill(newPalette[0]);
+        return;
+    }
+
+    if (newPalette.size() == this->palette.size()) {
+        return;
+    }
+
+    std::vector<unsigned int> indices(VOLUME);
+    for (int i = 0; i < VOLUME; i++) {
+        indices[i] = remap[this->getIndex(i)];
+    }
+
+    this->palette = std::move(newPalette);
+    this->resize(bitsFor(this->palette.size()));
+
+    for (int i = 0; i < VOLUME; i++) {
+        this->setIndex(i, indices[i]);
+    }
+}
+
+std::size_t ChunkSection::memoryUsage() const {
+    return this->palette.capacity() * sizeof(BlockId) +
+           this->data.capacity() * sizeof(std::uint64_t);
+}
+
+void ChunkSection::setIndex(int index, unsigned int value) {
+    assert(this->bits > 0);
+
+    std::uint64_t &word{this->data[index >> this->wordShift]};
+    int offset{(index & ((1 << this->wordShift) - 1)) << this->bitsShift};
+
+    word &= ~(this->mask << offset);
+    word |= (static_cast<std::uint64_t>(value) & this->mask) << offset;
+}
+
+unsigned int ChunkSection::findOrAddPalette(BlockId block) {
+    auto it{std::find(this->palette.begin(), this->palette.end(), block)};
+    if (it != this->palette.end()) {
+        return static_cast<unsigned int>(it - this->palette.begin());
+    }
+
+    this->palette.push_back(block);
+
+    if (this->bits == 0 ||
+        this->palette.size() > (std::size_t{1} << this->bits)) {
+        this->resize(bitsFor(this->palette.size()));
+    }
+
+    return static_cast<unsigned int>(this->palette.size() - 1);
+}
+
+void ChunkSection::resize(int newBits) {
+    assert(newBits > 0 && newBits <= 16);
+
+    std::vector<unsigned int> indices(VOLUME, 0);
+    if (this->bits > 0) {
+        for (int i = 0; i < VOLUME; i++) {
+            indices[i] = this->getIndex(i);
+        }
+    }
+
+    this->bits = newBits;
+    this->bitsShift = log2(newBits);
+    this->wordShift = log2(64 / newBits);
+    this->mask = (std::uint64_t{1} << newBits) - 1;
+
+    this->data.assign(VOLUME >> this->wordShift, 0);
+
+    for (int i = 0; i < VOLUME; i++) {
+        if (indices[i]) {
+            this->setIndex(i, indices[i]);
+        }
+    }
+}
+
+} // namespace world
+
+} // namespace mine
@@ -0,0 +1,149 @@
+#include "world/TerrainGenerator.hpp"
+#include "utils/Profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace mine {
+
+namespace world {
+
+namespace {
+
+float lattice(std::uint32_t seed, int x, int z) {
+    std::uint32_t hash{seed ^ 0x9e3779b9u};
+    hash ^= static_cast<std::uint32_t>(x) * 0x85ebca6bu;
+    hash = (hash << 13) | (hash >> 19);
+    hash ^= static_cast<std::uint32_t>(z) * 0xc2b2ae35u;
+    hash ^= hash >> 16;
+    hash *= 0x7feb352du;
+    hash ^= hash >> 15;
+
+    return static_cast<float>(hash & 0xffffff) / static_cast<float>(0xffffff);
+}
+
+float smooth(float t) { return t * t * (3.0f - 2.0f * t); }
+
+} // namespace
+
+TerrainGenerator::TerrainGenerator(std::uint32_t seed) : seed{seed} {}
+
+void TerrainGenerator::generate(Chunk &chunk) const {
+    utils::ProfileZone zone{"generate"};
+
+    glm::ivec3 origin{chunk.getOrigin()};
+
+    int heights[Chunk::SIZE][Chunk::SIZE];
+    int lowest{heights[0][0] = this->heightAt(origin.x, origin.z)};
+    int highest{lowest};
+
+    for (int z = 0; z < Chunk::SIZE; z++) {
+        for (int x = 0; x < Chunk::SIZE; x++) {
+            int height{this->heightAt(origin.x + x, origin.z + z)};
+            heights[z][x] = height;
+
+            lowest = std::min(lowest, height);
+            highest = std::max(highest, height);
+        }
+    }
+
+    // Entirely above or below the surface, keep the single-value section
+    if (origin.y > highest) {
+        chunk.getSection().fill(blocks::AIR);
+        chunk.markDirty();
+        return;
+    }
+
+    if (origin.y + Chunk::SIZE <= lowest - 3) {
+        chunk.getSection().fill(blocks::STONE);
+        chunk.markDirty();
+        return;
+    }
+
+    for (int z = 0; z < Chunk::SIZE; z++) {
+        for (int x = 0; x < Chunk::SIZE; x++) {
+            int height{heights[z][x]};
+
+            for (int y = 0; y < Chunk::SIZE; y++) {
+                int worldY{origin.y + y};
+
+                BlockId block{blocks::AIR};
+                if (worldY == height) {
+                    block = blocks::GRASS;
+                } else if (worldY < height - 3) {
+                    block = blocks::STONE;
+                } else if (worldY < height) {
+                    block = blocks::DIRT;
+                }
+
+                chunk.setBlock(x, y, z, block);
+            }
+        }
+    }
+}
+
+void TerrainGenerator::generate(World &world, glm::ivec3 from,
+                                glm::ivec3 to) const {
+    for (int y = from.y; y < to.y; y++) {
+        for (int z = from.z; z < to.z; z++) {
+            for (int x = from.x; x < to.x; x++) {
+                this->generate(world.loadChunk({x, y, z}));
+            }
+        }
+    }
+}
+
+void TerrainGenerator::generate(World &world, glm::ivec3 from, glm::ivec3 to,
+                                jobs::JobSystem &jobSystem) const {
+    // The World itself isn't thread safe, load chunks up front and only hand
+    // the independent chunks to the workers
+    std::vector<Chunk *> chunks;
+    for (int y = from.y; y < to.y; y++) {
+        for (int z = from.z; z < to.z; z++) {
+            for (int x = from.x; x < to.x; x++) {
+                chunks.push_back(&world.loadChunk({x, y, z}));
+            }
+        }
+    }
+
+    jobSystem.parallelFor(chunks.size(), [this, &chunks](std::size_t i) {
+        this->generate(*chunks[i]);
+    });
+}
+
+int TerrainGenerator::heightAt(int x, int z) const {
+    float height{0.0f};
+    float amplitude{16.0f};
+    float frequency{1.0f / 64.0f};
+
+    for (int octave = 0; octave < 4; octave++) {
+        height += this->noise(x * frequency, z * frequency) * amplitude;
+        amplitude *= 0.5f;
+        frequency *= 2.0f;
+    }
+
+    return static_cast<int>(height) + 8;
+}
+
+float TerrainGenerator::noise(float x, float z) const {
+    int cellX{static_cast<int>(std::floor(x))};
+    int cellZ{static_cast<int>(std::floor(z))};
+
+    float fracX{smooth(x - cellX)};
+    float fracZ{smooth(z - cellZ)};
+
+    float a{lattice(this->seed, cellX, cellZ)};
+    float b{lattice(this->seed, cellX + 1, cellZ)};
+    float c{lattice(this->seed, cellX, cellZ + 1)};
+    float d{lattice(this->seed, cellX + 1, cellZ + 1)};
+
+    float top{a + (b - a) * fracX};
+    float bottom{c + (d - c) * fracX};
+
+    return top + (bottom - top) * fracZ;
+}
+
+} // namespace world
+
+} // namespace mine
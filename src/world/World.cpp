@@ -0,0 +1,193 @@
+#include "world/World.hpp"
+
+#include <cassert>
+
+namespace mine {
+
+namespace world {
+
+namespace {
+
+constexpr std::size_t INITIAL_CAPACITY{64};
+
+/**
+ * splitmix64 finalizer, spreads neighbouring coordinates across the table
+ */
+std::size_t hashKey(std::uint64_t key) {
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ull;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebull;
+    key ^= key >> 31;
+
+    return static_cast<std::size_t>(key);
+}
+
+} // namespace
+
+World::World() : slots(INITIAL_CAPACITY) {}
+
+World::World(World &&other)
+    : slots{std::move(other.slots)}, count{other.count},
+      lastKey{other.lastKey}, lastChunk{other.lastChunk} {
+    // An empty table would make findSlot's mask wrap around
+    other.slots = std::vector<Slot>(INITIAL_CAPACITY);
+    other.count = 0;
+    other.lastChunk = nullptr;
+}
+
+World &World::operator=(World &&other) {
+    if (this != &other) {
+        this->slots = std::move(other.slots);
+        this->count = other.count;
+        this->lastKey = other.lastKey;
+        this->lastChunk = other.lastChunk;
+
+        other.slots = std::vector<Slot>(INITIAL_CAPACITY);
+        other.count = 0;
+        other.lastChunk = nullptr;
+    }
+
+    return *this;
+}
+
+Chunk &World::loadChunk(glm::ivec3 position, BlockId fill) {
+    if (Chunk *chunk = this->getChunk(position)) {
+        return *chunk;
+    }
+
+    // Keep the load factor under 3/4
+    if ((this->count + 1) * 4 > this->slots.size() * 3) {
+        this->grow();
+    }
+
+    std::uint64_t key{packChunkKey(position)};
+    Slot &slot{this->slots[this->findSlot(key)]};
+
+    slot.key = key;
+    slot.chunk = std::make_unique<Chunk>(position, fill);
+    this->count++;
+
+    this->lastKey = key;
+    this->lastChunk = slot.chunk.get();
+
+    return *slot.chunk;
+}
+
+bool World::unloadChunk(glm::ivec3 position) {
+    std::uint64_t key{packChunkKey(position)};
+    std::size_t mask{this->slots.size() - 1};
+    std::size_t index{this->findSlot(key)};
+
+    if (!this->slots[index].chunk) {
+        return false;
+    }
+
+    if (this->lastChunk == this->slots[index].chunk.get()) {
+        this->lastChunk = nullptr;
+    }
+
+    this->slots[index].chunk.reset();
+    this->count--;
+
+    // Backward shift deletion: pull later entries of the probe run into the
+    // hole so lookups never need tombstones
+    std::size_t hole{index};
+    for (std::size_t next = (hole + 1) & mask; this->slots[next].chunk;
+         next = (next + 1) & mask) {
+        std::size_t home{hashKey(this->slots[next].key) & mask};
+
+        bool movable{hole <= next ? (home <= hole || home > next)
+                                  : (home <= hole && home > next)};
+        if (movable) {
+            this->slots[hole] = std::move(this->slots[next]);
+            hole = next;
+        }
+    }
+
+    return true;
+}
+
+void World::setBlock(glm::ivec3 position, BlockId block) {
+    glm::ivec3 chunkPosition{toChunkCoord(position.x),
+                             toChunkCoord(position.y),
+                             toChunkCoord(position.z)};
+    glm::ivec3 local{toLocalCoord(position.x), toLocalCoord(position.y),
+                     toLocalCoord(position.z)};
+
+    Chunk &chunk{this->loadChunk(chunkPosition)};
+    if (chunk.getBlock(local.x, local.y, local.z) == block) {
+        return;
+    }
+
+    chunk.setBlock(local.x, local.y, local.z, block);
+
+    for (int axis = 0; axis < 3; axis++) {
+        int side{0};
+        if (local[axis] == 0) {
+            side = -1;
+        } else if (local[axis] == Chunk::SIZE - 1) {
+            side = 1;
+        } else {
+            continue;
+        }
+
+        glm::ivec3 neighbourPosition{chunkPosition};
+        neighbourPosition[axis] += side;
+
+        if (Chunk *neighbour = this->getChunk(neighbourPosition)) {
+            neighbour->markDirty();
+        }
+    }
+}
+
+void World::forEachChunk(const std::function<void(Chunk &)> &callback) {
+    for (auto &slot : this->slots) {
+        if (slot.chunk) {
+            callback(*slot.chunk);
+        }
+    }
+}
+
+std::size_t World::size() const { return this->count; }
+
+std::size_t World::capacity() const { return this->slots.size(); }
+
+Chunk *World::findChunk(std::uint64_t key) const {
+    const Slot &slot{this->slots[this->findSlot(key)]};
+    if (!slot.chunk) {
+        return nullptr;
+    }
+
+    this->lastKey = key;
+    this->lastChunk = slot.chunk.get();
+
+    return slot.chunk.get();
+}
+
+std::size_t World::findSlot(std::uint64_t key) const {
+    std::size_t mask{this->slots.size() - 1};
+    std::size_t index{hashKey(key) & mask};
+
+    while (this->slots[index].chunk && this->slots[index].key != key) {
+        index = (index + 1) & mask;
+    }
+
+    return index;
+}
+
+void World::grow() {
+    std::vector<Slot> old{std::move(this->slots)};
+    this->slots = std::vector<Slot>(old.size() * 2);
+
+    for (auto &slot : old) {
+        if (slot.chunk) {
+            std::size_t index{this->findSlot(slot.key)};
+            this->slots[index] = std::move(slot);
+        }
+    }
+}
+
+} // namespace world
+
+} // namespace mine